@@ -0,0 +1,506 @@
+#include "deus-console.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+
+// Benchmarks for the console engine, run with something like:
+// g++ -O2 -std=c++17 bench.cpp -o bench && ./bench
+
+// Results are written here so the optimizer cant discard timed work
+static volatile int benchSink = 0;
+
+// Times a callback over a number of iterations, returning nanoseconds per iteration
+template <typename F>
+inline double timeNsPerOp(size_t iterations, F func) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    func(i);
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+// Names and values of benchmark variables, the console only references them so they must outlive it
+template <typename T>
+struct TBenchVars {
+  std::vector<std::string> names;
+  std::vector<T> values;
+};
+
+// Registers count variables named by makeName(i), flagsFor picks the flags of each one when given
+template <typename T, typename F>
+inline void registerBenchVars(IDeusConsoleManager& console, TBenchVars<T>& vars, size_t count, F makeName, const char* description = "", int (*flagsFor)(size_t) = NULL) {
+  vars.names.clear();
+  vars.names.reserve(count); // Registered names point into these strings, so they must never move
+  vars.values.assign(count, T());
+  for (size_t i = 0; i < count; i++) {
+    vars.names.push_back(makeName(i));
+  }
+  for (size_t i = 0; i < count; i++) {
+    console.registerCVar(vars.names[i].c_str(), vars.values[i], description, flagsFor != NULL ? flagsFor(i) : DEUS_CVAR_DEFAULT);
+  }
+}
+
+// Registers count variables named by a prefix followed by their index
+template <typename T>
+inline void registerBenchVars(IDeusConsoleManager& console, TBenchVars<T>& vars, const char* prefix, size_t count) {
+  registerBenchVars(console, vars, count, [prefix](size_t i) {
+    return prefix + std::to_string(i);
+  });
+}
+
+// Measures name lookup latency as the registry grows, it should stay flat
+inline void benchLookup() {
+  std::cout << "Lookup latency by registry size" << std::endl;
+  std::cout << "entries\tgetCVar ns\trunCommand ns" << std::endl;
+
+  const size_t sizes[] = { 10, 100, 1000, 10000, 100000 };
+  const size_t iterations = 200000;
+  for (size_t count : sizes) {
+    TBenchVars<int> vars;
+    IDeusConsoleManager console;
+    registerBenchVars(console, vars, "bench.var", count);
+    const std::vector<std::string>& names = vars.names;
+
+    // Pick names up front so the timed loop only measures the console
+    std::mt19937 rng(1234);
+    std::vector<const char*> queries(1024);
+    for (auto& query : queries) {
+      query = names[rng() % count].c_str();
+    }
+
+    int sum = 0;
+    const double getNs = timeNsPerOp(iterations, [&](size_t i) {
+      sum += console.getCVar<int>(queries[i & 1023]);
+    });
+
+    std::string output;
+    const double runNs = timeNsPerOp(iterations, [&](size_t i) {
+      console.runCommand(queries[i & 1023], output);
+    });
+
+    benchSink = sum;
+    std::cout << count << "\t" << getNs << "\t\t" << runNs << std::endl;
+  }
+}
+
+// Compares lookups hashed at runtime with names hashed at compile time
+inline void benchLiteralLookup() {
+  int value = 1;
+  IDeusConsoleManager console;
+  console.registerCVar(DEUS_CVAR("bench.literal.variable"), value);
+
+  int sum = 0;
+  const size_t iterations = 1000000;
+  const char* runtimeName = "bench.literal.variable";
+  const double runtimeNs = timeNsPerOp(iterations, [&](size_t) {
+    sum += console.getCVar<int>(runtimeName);
+  });
+  const double literalNs = timeNsPerOp(iterations, [&](size_t) {
+    sum += console.getCVar<int>(DEUS_CVAR("bench.literal.variable"));
+  });
+
+  benchSink = sum;
+  std::cout << std::endl << "getCVar runtime hashed name ns: " << runtimeNs << std::endl;
+  std::cout << "getCVar compile time hashed name ns: " << literalNs << std::endl;
+}
+
+// The token and strtok based parser that DeusCommandTokenizer replaced, kept to compare throughput against
+struct LegacyCommandToken {
+  char str[512];
+  uint8_t type = 0;
+};
+
+inline void legacyParseCommand(const char* inputCmd, char* target, std::vector<LegacyCommandToken>& tokens) {
+  char command[512];
+  strcpy(command, inputCmd);
+  trimStr(command);
+
+  const char* whitespaceStr = " ";
+  bool isStringParsing = false;
+  char* cmdToken = strtok(command, whitespaceStr);
+  LegacyCommandToken commandToken;
+  bool isFirstToken = true;
+  while (cmdToken != NULL) {
+    if (isFirstToken) {
+      strcpy(target, cmdToken);
+      isFirstToken = false;
+    } else {
+      const size_t tokenLength = strlen(cmdToken);
+      const bool isStringStart = !isStringParsing && (cmdToken[0] == '\'' || cmdToken[0] == '"');
+      const bool isStringEnd = isStringParsing && (cmdToken[tokenLength - 1] == '\'' || cmdToken[tokenLength - 1] == '"');
+      const int tokenNumericalType = !isStringParsing && !isStringStart && !isStringEnd ? isNumericStr(cmdToken, tokenLength) : 0;
+      commandToken.type = tokenNumericalType;
+      if (tokenNumericalType) {
+        strcpy(commandToken.str, cmdToken);
+      } else if (isStringStart) {
+        isStringParsing = true;
+        strcpy(commandToken.str, &cmdToken[1]);
+        strcat(commandToken.str, whitespaceStr);
+      } else if (isStringEnd) {
+        isStringParsing = false;
+        strcat(commandToken.str, cmdToken);
+        commandToken.str[strlen(commandToken.str) - 1] = 0;
+      } else if (isStringParsing) {
+        strcat(commandToken.str, cmdToken);
+        strcat(commandToken.str, whitespaceStr);
+      } else {
+        strcpy(commandToken.str, cmdToken);
+      }
+      if (!isStringParsing) {
+        tokens.push_back(commandToken);
+      }
+    }
+    cmdToken = strtok(NULL, whitespaceStr);
+  }
+}
+
+// Measures command parsing throughput in commands per second
+inline void benchParse() {
+  const char* commands[] = {
+    "test.integer 12345",
+    "test.string 'this is a quoted string'",
+    "add 1 2 3 4 5 6 7 8",
+    "r.shadow.cascade.count",
+  };
+  const size_t iterations = 400000;
+  std::cout << std::endl << "Parse throughput (commands/sec)" << std::endl;
+
+  char legacyTarget[512];
+  size_t tokenSum = 0;
+  const double legacyNs = timeNsPerOp(iterations, [&](size_t i) {
+    std::vector<LegacyCommandToken> tokens;
+    legacyParseCommand(commands[i & 3], legacyTarget, tokens);
+    tokenSum += tokens.size();
+  });
+
+  IDeusConsoleManager console;
+  const double parseNs = timeNsPerOp(iterations, [&](size_t i) {
+    DeusCommandType commandResult;
+    console.parseCommand(commands[i & 3], commandResult);
+    tokenSum += commandResult.argc;
+  });
+
+  const double tokenizeNs = timeNsPerOp(iterations, [&](size_t i) {
+    DeusCommandTokenizer tokenizer(commands[i & 3]);
+    std::string_view token;
+    bool isQuoted = false;
+    while (tokenizer.next(token, isQuoted)) {
+      tokenSum += token.size();
+    }
+  });
+
+  benchSink = (int)tokenSum;
+  std::cout << "legacy strtok parseCommand: " << (size_t)(1e9 / legacyNs) << std::endl;
+  std::cout << "parseCommand: " << (size_t)(1e9 / parseNs) << std::endl;
+  std::cout << "DeusCommandTokenizer only: " << (size_t)(1e9 / tokenizeNs) << std::endl;
+}
+
+// Compares running a script of statements one runCommand at a time against a single runBatch
+inline void benchBatch() {
+  const size_t count = 10000;
+  TBenchVars<int> vars;
+  IDeusConsoleManager console;
+  registerBenchVars(console, vars, "bench.batch", count);
+  const std::vector<std::string>& names = vars.names;
+
+  std::string script;
+  std::vector<std::string> lines;
+  for (size_t i = 0; i < count; i++) {
+    lines.push_back(names[i] + " " + std::to_string(i));
+    script += lines.back() + "\n";
+  }
+
+  std::string output;
+  const double lineNs = timeNsPerOp(1, [&](size_t) {
+    for (const std::string& line : lines) {
+      console.runCommand(line.c_str(), output);
+    }
+  });
+
+  DeusBatchResult result;
+  const double batchNs = timeNsPerOp(1, [&](size_t) {
+    console.runBatch(script, result);
+  });
+
+  std::cout << std::endl << "Running " << count << " statements" << std::endl;
+  std::cout << "runCommand per line ms: " << lineNs / 1e6 << std::endl;
+  std::cout << "runBatch ms: " << batchNs / 1e6 << std::endl;
+}
+
+// Measures loading a 20k line script file through execFile
+inline void benchExec() {
+  const size_t count = 20000;
+  TBenchVars<float> vars;
+  IDeusConsoleManager console;
+  registerBenchVars(console, vars, "bench.exec", count);
+  const std::vector<std::string>& names = vars.names;
+
+  FILE* file = fopen("bench_exec.cfg", "wb");
+  fputs("// Generated benchmark script\n", file);
+  for (size_t i = 0; i < count; i++) {
+    fprintf(file, "%s %zu.5\n", names[i].c_str(), i);
+  }
+  fclose(file);
+
+  DeusBatchResult result;
+  console.execFile("bench_exec.cfg", result);
+  remove("bench_exec.cfg");
+  std::cout << std::endl << "execFile " << result.entries.size() << " lines ms: " << result.elapsedMs << std::endl;
+}
+
+// Measures saving and restoring a binary snapshot of 10k variables
+inline void benchSnapshot() {
+  const size_t count = 10000;
+  TBenchVars<int> vars;
+  IDeusConsoleManager console;
+  registerBenchVars(console, vars, "bench.snapshot", count);
+
+  std::vector<uint8_t> snapshot;
+  const double saveNs = timeNsPerOp(100, [&](size_t) {
+    console.saveSnapshot(snapshot);
+  });
+  const double restoreNs = timeNsPerOp(100, [&](size_t i) {
+    vars.values[i % count] = (int)i;
+    console.restoreSnapshot(snapshot);
+  });
+
+  std::cout << std::endl << "Snapshot of " << count << " variables (" << snapshot.size() << " bytes)" << std::endl;
+  std::cout << "saveSnapshot ms: " << saveNs / 1e6 << std::endl;
+  std::cout << "restoreSnapshot ms: " << restoreNs / 1e6 << std::endl;
+}
+
+// Measures commands queued by producer threads while the main thread drains them
+inline void benchQueue() {
+  const size_t producers = 4;
+  const size_t perProducer = 50000;
+  IDeusConsoleManager console;
+  int value = 0;
+  console.registerCVar("bench.queue", value);
+
+  // Uncontended cost of a full enqueue and drain round trip
+  const double roundTripNs = timeNsPerOp(1000, [&](size_t) {
+    for (size_t i = 0; i < DEUS_COMMAND_QUEUE_CAPACITY; i++) {
+      console.enqueueCommand("bench.queue 1");
+    }
+    console.drainQueue();
+  }) / DEUS_COMMAND_QUEUE_CAPACITY;
+
+  size_t drained = 0;
+  const double totalNs = timeNsPerOp(1, [&](size_t) {
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; p++) {
+      threads.emplace_back([&console, perProducer]() {
+        for (size_t i = 0; i < perProducer; i++) {
+          while (!console.enqueueCommand("bench.queue 1")) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+    while (drained < producers * perProducer) {
+      drained += console.drainQueue();
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  });
+
+  std::cout << std::endl << "Queue of " << drained << " commands from " << producers << " threads" << std::endl;
+  std::cout << "enqueue and drain ns/command, single thread: " << roundTripNs << std::endl;
+  std::cout << "enqueue and drain ns/command, contended: " << totalNs / drained << std::endl;
+}
+
+// Measures ticking with many commands pending, ticks should only pay for commands that expire
+inline void benchSchedule() {
+  IDeusConsoleManager console;
+  int value = 0;
+  console.registerCVar("bench.schedule", value);
+  const double idleTickNs = timeNsPerOp(10000, [&](size_t) {
+    console.tick();
+  });
+  for (size_t i = 0; i < 100000; i++) {
+    console.scheduleCommand("bench.schedule 1", 1000000);
+  }
+  const double pendingTickNs = timeNsPerOp(10000, [&](size_t) {
+    console.tick();
+  });
+
+  std::cout << std::endl << "Scheduler tick with nothing due" << std::endl;
+  std::cout << "ns/tick, empty: " << idleTickNs << std::endl;
+  std::cout << "ns/tick, " << console.scheduledCount() << " pending: " << pendingTickNs << std::endl;
+}
+
+// Measures a batch of slow thread safe methods run serially and on the worker pool
+inline void benchWorkerPool() {
+  const size_t count = 2000;
+  const size_t workerCount = std::max<size_t>(std::thread::hardware_concurrency(), 2);
+  IDeusConsoleManager console;
+  console.registerMethod("bench.validate", [](DeusCommandType&) {
+    uint64_t hash = 14695981039346656037ull;
+    for (int i = 0; i < 20000; i++) {
+      hash = (hash ^ (uint64_t)i) * 1099511628211ull;
+    }
+    benchSink = (int)hash;
+  }, "", DEUS_METHOD_THREADSAFE);
+
+  std::string script;
+  for (size_t i = 0; i < count; i++) {
+    script += "bench.validate\n";
+  }
+
+  DeusBatchResult result;
+  const double serialNs = timeNsPerOp(1, [&](size_t) {
+    console.runBatch(script, result);
+  });
+  console.setWorkerCount(workerCount);
+  result.clear();
+  const double parallelNs = timeNsPerOp(1, [&](size_t) {
+    console.runBatch(script, result);
+  });
+
+  std::cout << std::endl << "Batch of " << count << " thread safe methods" << std::endl;
+  std::cout << "serial ms: " << serialNs / 1e6 << std::endl;
+  std::cout << workerCount << " workers ms: " << parallelNs / 1e6 << std::endl;
+}
+
+// Measures full registry scans, which stream through the registry columns
+inline void benchScan() {
+  const size_t count = 50000;
+  TBenchVars<int> vars;
+  IDeusConsoleManager console;
+  registerBenchVars(console, vars, count, [](size_t i) {
+    return "bench.scan" + std::to_string(i);
+  }, "", [](size_t i) {
+    return i % 8 == 0 ? (int)DEUS_CVAR_DEVELOPER : (int)DEUS_CVAR_DEFAULT;
+  });
+
+  size_t helpLength = 0;
+  const double helpNs = timeNsPerOp(100, [&](size_t) {
+    console.forEachHelp([&helpLength](std::string_view name, const char*) {
+      helpLength += name.size();
+    });
+  });
+  std::vector<std::string_view> found;
+  const double flagNs = timeNsPerOp(100, [&](size_t) {
+    console.findVariablesWithFlags(DEUS_CVAR_DEVELOPER, found);
+  });
+  benchSink = (int)(helpLength + found.size());
+
+  std::cout << std::endl << "Scanning " << count << " variables" << std::endl;
+  std::cout << "forEachHelp us: " << helpNs / 1e3 << std::endl;
+  std::cout << "findVariablesWithFlags us: " << flagNs / 1e3 << std::endl;
+
+  // Help built into one string versus streamed into a sink that only counts bytes
+  console.bindBaseCommands();
+  std::string helpOutput;
+  const double helpStringNs = timeNsPerOp(20, [&](size_t) {
+    console.runCommand("help", helpOutput);
+  });
+  size_t streamedBytes = 0;
+  auto countBytes = [&streamedBytes](std::string_view text) {
+    streamedBytes += text.size();
+  };
+  const double helpSinkNs = timeNsPerOp(20, [&](size_t) {
+    console.runCommand("help", countBytes);
+  });
+  benchSink = (int)(helpOutput.size() + streamedBytes);
+  std::cout << "help to string us: " << helpStringNs / 1e3 << std::endl;
+  std::cout << "help to sink us: " << helpSinkNs / 1e3 << std::endl;
+
+  // Completion only walks the names under the prefix
+  std::vector<std::string_view> matches;
+  const double completeNs = timeNsPerOp(1000, [&](size_t) {
+    console.complete("bench.scan4999", matches);
+  });
+  std::cout << "complete ns (" << matches.size() << " matches): " << completeNs << std::endl;
+}
+
+// Fuzzy search over dotted names shaped like real engine variables
+inline void benchSearch() {
+  const char* groups[] = { "r", "net", "sv", "cl", "snd", "ui", "phys", "ai" };
+  const char* systems[] = { "shadow", "texture", "mesh", "light", "post", "particle", "terrain", "water" };
+  const char* fields[] = { "count", "quality", "scale", "enable", "distance", "bias", "size", "debug" };
+  const size_t count = 50000;
+  TBenchVars<int> vars;
+  IDeusConsoleManager console;
+  registerBenchVars(console, vars, count, [&](size_t i) {
+    return std::string(groups[i % 8]) + "." + systems[(i / 8) % 8] + "." + fields[(i / 64) % 8] + std::to_string(i / 512);
+  }, "Bench variable");
+
+  std::vector<DeusSearchMatch> matches;
+  const char* queries[] = { "rshcount", "sndwatdist", "xyz", "quality" };
+  std::cout << std::endl << "Fuzzy search over " << count << " names" << std::endl;
+  for (const char* query : queries) {
+    const double searchNs = timeNsPerOp(50, [&](size_t) {
+      console.search(query, matches);
+    });
+    std::cout << "search \"" << query << "\" us (" << matches.size() << " matches): " << searchNs / 1e3 << std::endl;
+  }
+
+  // Namespace queries only walk the subtree under their literal prefix
+  size_t namespaceCount = 0;
+  const double namespaceNs = timeNsPerOp(1000, [&](size_t) {
+    namespaceCount = 0;
+    console.forEachInNamespace("snd.water.debug*", [&namespaceCount](std::string_view, const char*) {
+      namespaceCount++;
+    });
+  });
+  std::cout << "forEachInNamespace us (" << namespaceCount << " matches): " << namespaceNs / 1e3 << std::endl;
+}
+
+// Appending log lines to the output ring from one and several threads, then reading back the newest lines
+inline void benchOutputRing() {
+  DeusOutputRing ring(4096, 256 * 1024);
+  const std::string line = "r.shadow.cascade.count = 4";
+  const double appendNs = timeNsPerOp(1000000, [&](size_t) {
+    ring.appendLine(line);
+  });
+
+  const size_t threadCount = 4;
+  const size_t perThread = 250000;
+  const auto startTime = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < threadCount; t++) {
+    threads.emplace_back([&ring, &line, perThread]() {
+      for (size_t i = 0; i < perThread; i++) {
+        ring.appendLine(line);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  const double threadedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count() / (threadCount * perThread);
+
+  size_t renderedBytes = 0;
+  const double renderNs = timeNsPerOp(1000, [&](size_t) {
+    ring.forEachLast(100, [&renderedBytes](std::string_view text) {
+      renderedBytes += text.size();
+    });
+  });
+  benchSink = (int)renderedBytes;
+
+  std::cout << std::endl << "Output ring" << std::endl;
+  std::cout << "appendLine ns: " << appendNs << std::endl;
+  std::cout << "appendLine from " << threadCount << " threads ns: " << threadedNs << std::endl;
+  std::cout << "forEachLast 100 lines us: " << renderNs / 1e3 << std::endl;
+}
+
+// Entry point
+int main() {
+  benchLookup();
+  benchLiteralLookup();
+  benchParse();
+  benchBatch();
+  benchExec();
+  benchSnapshot();
+  benchQueue();
+  benchSchedule();
+  benchWorkerPool();
+  benchScan();
+  benchSearch();
+  benchOutputRing();
+  return 0;
+}
@@ -13,10 +13,41 @@
 #include <sstream>
 #include <memory>
 #include <vector>
+#include <algorithm>
 #include <exception>
 #include <cassert>
 #include <string.h>
+#include <string_view>
+#include <charconv>
 #include <type_traits>
+#include <limits>
+#include <cerrno>
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <tuple>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DEUS_CONSOLE_SSE2 1
+#include <emmintrin.h>
+#else
+#define DEUS_CONSOLE_SSE2 0
+#endif
+
+#if defined(_WIN32)
+#define DEUS_CONSOLE_MMAP 0
+#else
+#define DEUS_CONSOLE_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #define TEXT(txt) txt \
 
@@ -36,6 +67,25 @@ enum EDeusCVarFlags {
   DEUS_CVAR_DEVELOPER    = (1 << 1), // Console variables marked with this flag cant be changed in a final build
   DEUS_CVAR_READONLY     = (1 << 2), // Console variables cannot be changed by the user
   DEUS_CVAR_UNREGISTERED = (1 << 3), // Doesnt get registered to console manager
+  DEUS_CVAR_ATOMIC       = (1 << 4), // Value is a std::atomic that can be read from any thread, set automatically
+};
+
+enum EDeusMethodFlags {
+  DEUS_METHOD_DEFAULT    = 0, // Default, method only runs on the thread that runs the command
+  DEUS_METHOD_THREADSAFE = (1 << 1), // Method can run on the worker pool in parallel with other thread safe methods
+};
+
+// Detects std::atomic wrapped values, exposing the wrapped type
+template <typename T>
+struct TDeusAtomicTraits {
+  static constexpr bool isAtomic = false;
+  typedef T ValueType;
+};
+
+template <typename T>
+struct TDeusAtomicTraits<std::atomic<T>> {
+  static constexpr bool isAtomic = true;
+  typedef T ValueType;
 };
 
 // Flags that can be set on defined console variables
@@ -47,55 +97,959 @@ enum EDeusVarTypeFlags {
   DEUS_VARTYPE_BOOL_TRUE  = 4,
 };
 
-// Parsed command tokens from string input
+// Storage types of console variable values, used to write and validate snapshots
+enum EDeusValueType {
+  DEUS_VALUE_CUSTOM = 0, // Custom types and C strings arent snapshotted
+  DEUS_VALUE_BOOL   = 1,
+  DEUS_VALUE_INT    = 2,
+  DEUS_VALUE_UINT   = 3,
+  DEUS_VALUE_FLOAT  = 4,
+  DEUS_VALUE_STRING = 5,
+};
+
+// Returns the storage type for a variable type, atomics are stored as the type they wrap
+template <typename T>
+constexpr uint8_t deusValueType() {
+  if constexpr (TDeusAtomicTraits<T>::isAtomic) {
+    return deusValueType<typename TDeusAtomicTraits<T>::ValueType>();
+  } else if constexpr (std::is_same_v<T, bool>) {
+    return DEUS_VALUE_BOOL;
+  } else if constexpr (std::is_integral_v<T>) {
+    return std::is_signed_v<T> ? DEUS_VALUE_INT : DEUS_VALUE_UINT;
+  } else if constexpr (std::is_floating_point_v<T>) {
+    return DEUS_VALUE_FLOAT;
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    return DEUS_VALUE_STRING;
+  } else {
+    return DEUS_VALUE_CUSTOM;
+  }
+}
+
+// Parses text into an arithmetic type without depending on locale, throwing if the text
+// isnt a number or the value doesnt fit into the type. A leading + is accepted as atol and
+// strtod did, nan and inf are rejected so float variables always hold finite values
+template <typename T>
+inline T deusParseNumber(std::string_view str) {
+  static_assert(std::is_arithmetic_v<T>, "deusParseNumber requires an arithmetic type");
+  const char* first = str.data();
+  const char* last = first + str.size();
+  if (last - first > 1 && *first == '+' && first[1] != '-' && first[1] != '+') { // from_chars only takes a minus sign
+    first++;
+  }
+  T value = 0;
+  std::from_chars_result result = { first, std::errc() };
+  if constexpr (std::is_same_v<T, bool>) {
+    const int intValue = deusParseNumber<int>(str);
+    if (intValue != 0 && intValue != 1) {
+      throw DeusConsoleException("Value out of range: " + (std::string)str);
+    }
+    return intValue == 1;
+  } else if constexpr (std::is_integral_v<T>) {
+    if (std::is_unsigned_v<T> && first != last && *first == '-') {
+      throw DeusConsoleException("Value out of range: " + (std::string)str);
+    }
+    result = std::from_chars(first, last, value);
+  } else {
+#if defined(__cpp_lib_to_chars)
+    result = std::from_chars(first, last, value);
+#else
+    // Floating point from_chars is unavailable, fall back to strtod on a terminated copy
+    char buffer[128];
+    const size_t length = str.size() < sizeof(buffer) - 1 ? str.size() : sizeof(buffer) - 1;
+    memcpy(buffer, first, length);
+    buffer[length] = 0;
+    char* end = buffer;
+    errno = 0;
+    value = std::is_same_v<T, float> ? (T)strtof(buffer, &end) : (T)strtod(buffer, &end);
+    result.ptr = first + (end - buffer);
+    result.ec = errno == ERANGE ? std::errc::result_out_of_range : (end == buffer ? std::errc::invalid_argument : std::errc());
+#endif
+  }
+
+  if (result.ec == std::errc::result_out_of_range) {
+    throw DeusConsoleException("Value out of range: " + (std::string)str);
+  } else if (result.ec != std::errc() || result.ptr != last) {
+    throw DeusConsoleException("Invalid number: " + (std::string)str);
+  }
+  if constexpr (std::is_floating_point_v<T>) {
+    if (!std::isfinite(value)) {
+      throw DeusConsoleException("Invalid number: " + (std::string)str);
+    }
+  }
+  return value;
+}
+
+// Formats an arithmetic value into a buffer without depending on locale, returning the length written.
+// Floating point values use the shortest representation that parses back to the same value
+template <typename T>
+inline size_t deusFormatNumber(T value, char* buffer, size_t size) {
+  static_assert(std::is_arithmetic_v<T>, "deusFormatNumber requires an arithmetic type");
+  if constexpr (std::is_same_v<T, bool>) {
+    buffer[0] = value ? '1' : '0';
+    return 1;
+  } else if constexpr (std::is_integral_v<T>) {
+    return std::to_chars(buffer, buffer + size, value).ptr - buffer;
+  } else {
+#if defined(__cpp_lib_to_chars)
+    return std::to_chars(buffer, buffer + size, value).ptr - buffer;
+#else
+    // Floating point to_chars is unavailable, find the shortest precision that round trips
+    int length = 0;
+    for (int precision = std::numeric_limits<T>::digits10; precision <= std::numeric_limits<T>::max_digits10; precision++) {
+      length = snprintf(buffer, size, "%.*g", precision, (double)value);
+      if ((std::is_same_v<T, float> ? (T)strtof(buffer, NULL) : (T)strtod(buffer, NULL)) == value) {
+        break;
+      }
+    }
+    return length > 0 ? (size_t)length : 0;
+#endif
+  }
+}
+
+// Identifies binary console snapshots
+constexpr char DEUS_SNAPSHOT_MAGIC[] = "DCS2";
+
+// Limits for a single parsed command
+constexpr size_t DEUS_COMMAND_MAX_LENGTH = 256;
+constexpr size_t DEUS_COMMAND_MAX_TOKENS = 16;
+constexpr size_t DEUS_COMMAND_QUEUE_CAPACITY = 128; // Must be a power of two
+constexpr double DEUS_TASK_BUDGET_MS = 2.0; // Default time tick spends resuming long running methods
+constexpr uint8_t DEUS_ENTRY_METHOD = 0xFF; // Type tag of methods in the registry columns, variables use EDeusValueType
+constexpr uint32_t DEUS_TRIE_NONE = UINT32_MAX; // Trie node that no name ends at, or a missing node
+constexpr uint32_t DEUS_PENDING_NONE = UINT32_MAX; // Variable has no write waiting for the next frame
+
+// Parsed command tokens from string input, str is a null terminated slice of the owning command's buffer
 struct DeusCommandToken {
-  char str[512];
+  const char* str = "";
+  uint16_t length = 0;
   uint8_t type = 0;
 
-  int toInt() {
-    return atol(str);
+  int toInt() const {
+    return deusParseNumber<int>(std::string_view(str, length));
+  }
+
+  float toFloat() const {
+    return deusParseNumber<float>(std::string_view(str, length));
+  }
+};
+
+// Fixed capacity container storing its elements inline, so it never touches the heap
+template <typename T, size_t N>
+class TDeusInlineVector {
+  private:
+    T items[N];
+    size_t count = 0;
+
+  public:
+    void push_back(const T& item) {
+      if (this->count >= N) {
+        throw DeusConsoleException("Inline vector capacity exceeded");
+      }
+      this->items[this->count++] = item;
+    }
+
+    void clear() {
+      this->count = 0;
+    }
+
+    size_t size() const {
+      return this->count;
+    }
+
+    bool empty() const {
+      return this->count == 0;
+    }
+
+    static constexpr size_t capacity() {
+      return N;
+    }
+
+    T& operator[](size_t index) {
+      return this->items[index];
+    }
+
+    const T& operator[](size_t index) const {
+      return this->items[index];
+    }
+
+    T* begin() {
+      return this->items;
+    }
+
+    T* end() {
+      return this->items + this->count;
+    }
+
+    const T* begin() const {
+      return this->items;
+    }
+
+    const T* end() const {
+      return this->items + this->count;
+    }
+};
+
+// Receives command output as it is produced, so large outputs can be rendered or sent piece by piece instead of
+// being built up in one string. Wraps any callable taking a std::string_view without allocating, the callable
+// is referenced rather than copied so it must outlive the sink. A temporary lambda lives until the end of the
+// call it is passed to, so runCommand("help", [](std::string_view text) { ... }) is fine
+class DeusOutputSink {
+  private:
+    void (*func)(void* context, std::string_view text);
+    void* context;
+
+  public:
+    template <typename F, typename C = std::remove_reference_t<F>,
+              std::enable_if_t<std::is_invocable_v<C&, std::string_view> && !std::is_same_v<std::decay_t<F>, DeusOutputSink>> * = nullptr>
+    DeusOutputSink(F&& callable) : context((void*)&callable) {
+      this->func = [](void* callableContext, std::string_view text) {
+        (*static_cast<C*>(callableContext))(text);
+      };
+    }
+
+    void write(std::string_view text) const {
+      this->func(this->context, text);
+    }
+};
+
+// Fixed memory buffer of recent output lines that any thread can append to without locking, for servers that
+// run for weeks. Line records and their text live in two rings allocated once, an append claims a record and a
+// byte range with atomic counters and old lines are overwritten once either ring wraps. Readers copy a line out
+// then check no writer has lapped it since, so a line being overwritten is skipped rather than torn. A record is
+// claimed with a compare and swap so only one writer fills it at a time, a writer that laps another still filling
+// the same record waits for it, which only happens with more writers mid append than the ring has lines
+class DeusOutputRing {
+  private:
+    struct Line {
+      std::atomic<uint64_t> sequence{0}; // Twice the line index plus one once published, odd while being written
+      std::atomic<uint64_t> offset{0}; // Position in the byte stream, the arena holds it modulo its size
+      std::atomic<uint32_t> length{0};
+    };
+
+    std::unique_ptr<Line[]> lines;
+    std::unique_ptr<char[]> arena;
+    size_t lineMask;
+    size_t arenaMask;
+    std::atomic<uint64_t> nextLine{0};
+    std::atomic<uint64_t> nextByte{0};
+    std::atomic<uint64_t> clearedLine{0}; // Lines below this were cleared
+
+    static size_t roundUpPow2(size_t value) {
+      size_t result = 1;
+      while (result < value) {
+        result <<= 1;
+      }
+      return result;
+    }
+
+  public:
+    // Capacities are rounded up to powers of two, lines longer than the arena are truncated
+    DeusOutputRing(size_t lineCapacity = 1024, size_t arenaSize = 64 * 1024) {
+      this->lineMask = roundUpPow2(std::max(lineCapacity, (size_t)1)) - 1;
+      this->arenaMask = roundUpPow2(std::max(arenaSize, (size_t)1)) - 1;
+      this->lines.reset(new Line[this->lineMask + 1]);
+      this->arena.reset(new char[this->arenaMask + 1]);
+    }
+
+    // Appends a single line, safe to call from any thread
+    void appendLine(std::string_view line) {
+      const size_t arenaSize = this->arenaMask + 1;
+      const uint32_t length = (uint32_t)std::min(line.size(), arenaSize);
+      const uint64_t index = this->nextLine.fetch_add(1, std::memory_order_relaxed);
+      const uint64_t offset = this->nextByte.fetch_add(length, std::memory_order_relaxed);
+      Line& record = this->lines[index & this->lineMask];
+
+      // Claim the record from an older published line, waiting out an older writer still filling it. If a newer
+      // line already has it this one was overwritten before it was written, so it is dropped
+      const uint64_t writing = (index + 1) * 2 - 1;
+      uint64_t current = record.sequence.load(std::memory_order_relaxed);
+      while (true) {
+        if (current > writing) {
+          return;
+        } else if (current & 1) {
+          std::this_thread::yield();
+          current = record.sequence.load(std::memory_order_relaxed);
+        } else if (record.sequence.compare_exchange_weak(current, writing, std::memory_order_relaxed)) {
+          break;
+        }
+      }
+      std::atomic_thread_fence(std::memory_order_release); // Readers that see the new bytes also see the claims above
+
+      const size_t start = offset & this->arenaMask;
+      const size_t firstPart = std::min((size_t)length, arenaSize - start);
+      memcpy(this->arena.get() + start, line.data(), firstPart);
+      memcpy(this->arena.get(), line.data() + firstPart, length - firstPart);
+      record.offset.store(offset, std::memory_order_relaxed);
+      record.length.store(length, std::memory_order_relaxed);
+      record.sequence.store(writing + 1, std::memory_order_release);
+    }
+
+    // Appends text as one line per newline, a trailing newline doesnt add an empty line
+    void append(std::string_view text) {
+      size_t start = 0;
+      while (true) {
+        const size_t newline = text.find('\n', start);
+        if (newline == std::string_view::npos) {
+          if (start < text.size() || start == 0) {
+            this->appendLine(text.substr(start));
+          }
+          return;
+        }
+        this->appendLine(text.substr(start, newline - start));
+        start = newline + 1;
+      }
+    }
+
+    // Hides every line appended so far
+    void clear() {
+      this->clearedLine.store(this->nextLine.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    // Index of the oldest line still held, lines are numbered from zero as they are appended
+    uint64_t begin() const {
+      const uint64_t last = this->end();
+      const uint64_t capacity = this->lineMask + 1;
+      return std::max(this->clearedLine.load(std::memory_order_relaxed), last > capacity ? last - capacity : 0);
+    }
+
+    // Index one past the newest line
+    uint64_t end() const {
+      return this->nextLine.load(std::memory_order_acquire);
+    }
+
+    size_t size() const {
+      return (size_t)(this->end() - this->begin());
+    }
+
+    // Copies a line by index, returning false if it is no longer held, still being written or was overwritten
+    bool getLine(uint64_t index, std::string& out) const {
+      if (index < this->begin() || index >= this->end()) {
+        return false;
+      }
+      const Line& record = this->lines[index & this->lineMask];
+      const uint64_t published = (index + 1) * 2;
+      if (record.sequence.load(std::memory_order_acquire) != published) {
+        return false;
+      }
+
+      const uint64_t offset = record.offset.load(std::memory_order_relaxed);
+      const size_t length = record.length.load(std::memory_order_relaxed);
+      const size_t arenaSize = this->arenaMask + 1;
+      const size_t start = offset & this->arenaMask;
+      const size_t firstPart = std::min(length, arenaSize - start);
+      out.resize(length);
+      memcpy(&out[0], this->arena.get() + start, firstPart);
+      memcpy(&out[0] + firstPart, this->arena.get(), length - firstPart);
+
+      // Writers claim bytes before writing them, so the copy is intact if nothing has claimed past it since
+      std::atomic_thread_fence(std::memory_order_acquire);
+      return record.sequence.load(std::memory_order_relaxed) == published &&
+        this->nextByte.load(std::memory_order_relaxed) <= offset + arenaSize;
+    }
+
+    // Calls a function with each of the newest count lines that are still intact, oldest first
+    template <typename F>
+    void forEachLast(size_t count, F func) const {
+      std::string line;
+      const uint64_t last = this->end();
+      const uint64_t first = std::max(this->begin(), last - std::min((uint64_t)count, last));
+      for (uint64_t index = first; index < last; index++) {
+        if (this->getLine(index, line)) {
+          func(std::string_view(line));
+        }
+      }
+    }
+};
+
+// The parsed command containing tokens and a string for return value. The command text is copied
+// into an inline buffer that the target and tokens point into, so parsing never allocates
+struct DeusCommandType {
+  const char* target = "";
+  size_t argc = 0;
+  TDeusInlineVector<DeusCommandToken, DEUS_COMMAND_MAX_TOKENS> tokens;
+  std::string returnStr;
+  const DeusOutputSink* output = NULL; // Where write streams to, returnStr if NULL. Copies dont keep it
+  char buffer[DEUS_COMMAND_MAX_LENGTH];
+
+  DeusCommandType() {
+    this->buffer[0] = 0;
   }
 
-  float toFloat() {
-    return atof(str);
-  }
-};
+  // Writes output to the sink the command was run with, or appends it to returnStr when there is none
+  void write(std::string_view text) {
+    if (this->output != NULL) {
+      this->output->write(text);
+    } else {
+      this->returnStr.append(text);
+    }
+  }
+
+  DeusCommandType(const DeusCommandType& other) : returnStr(other.returnStr) {
+    this->copyTokens(other);
+  }
+
+  DeusCommandType(DeusCommandType&& other) : returnStr(std::move(other.returnStr)) {
+    this->copyTokens(other);
+  }
+
+  DeusCommandType& operator=(const DeusCommandType& other) {
+    this->returnStr = other.returnStr;
+    this->copyTokens(other);
+    return *this;
+  }
+
+  DeusCommandType& operator=(DeusCommandType&& other) {
+    this->returnStr = std::move(other.returnStr);
+    this->copyTokens(other);
+    return *this;
+  }
+
+  private:
+    // Copies the buffer and tokens of another command, pointing them at this command's buffer
+    void copyTokens(const DeusCommandType& other) {
+      memcpy(this->buffer, other.buffer, sizeof(this->buffer));
+      this->argc = other.argc;
+      this->tokens = other.tokens;
+      this->target = this->rebase(other, other.target);
+      for (DeusCommandToken& token : this->tokens) {
+        token.str = this->rebase(other, token.str);
+      }
+    }
+
+    // Moves a pointer into another command's buffer to the same offset in this one
+    const char* rebase(const DeusCommandType& other, const char* str) const {
+      const uintptr_t offset = (uintptr_t)str - (uintptr_t)other.buffer;
+      return offset < sizeof(other.buffer) ? this->buffer + offset : str;
+    }
+};
+
+// FNV-1a hash of a name, constexpr so that literal names can be hashed at compile time
+constexpr uint64_t deusHashName(const char* str, size_t len) {
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= (uint8_t)str[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+// A variable or method name along with its hash, the hash is computed once on construction
+// so tables can be probed without rehashing. Use DEUS_CVAR("name") to hash literals at compile time
+struct DeusCVarName {
+  std::string_view str;
+  uint64_t hash;
+
+  constexpr DeusCVarName(std::string_view str, uint64_t hash) : str(str), hash(hash) {}
+  constexpr DeusCVarName(std::string_view str) : str(str), hash(deusHashName(str.data(), str.size())) {}
+  constexpr DeusCVarName(const char* str) : DeusCVarName(std::string_view(str)) {}
+
+  constexpr bool operator==(const DeusCVarName& other) const {
+    return this->hash == other.hash && this->str == other.str;
+  }
+};
+
+// Hashes names by returning their precomputed hash
+struct DeusCVarNameHasher {
+  size_t operator()(const DeusCVarName& name) const noexcept {
+    return (size_t)name.hash;
+  }
+};
+
+// Wraps a string literal as a name hashed at compile time, skipping runtime hashing on registration and lookup
+#define DEUS_CVAR(name) DeusCVarName(std::string_view(name, sizeof(name) - 1), std::integral_constant<uint64_t, deusHashName(name, sizeof(name) - 1)>::value)
+
+// Checks a list of names for hash collisions or duplicates at compile time
+template <size_t N>
+constexpr bool deusNamesUnique(const DeusCVarName (&names)[N]) {
+  for (size_t i = 0; i < N; i++) {
+    for (size_t j = i + 1; j < N; j++) {
+      if (names[i].hash == names[j].hash) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Asserts that the names used within a translation unit dont collide, for example:
+// DEUS_CVAR_ASSERT_UNIQUE("r.shadowQuality", "r.shadowDistance");
+#define DEUS_CVAR_ASSERT_UNIQUE(...) static_assert(deusNamesUnique({ __VA_ARGS__ }), "Console variable names collide")
+
+// Readability typedefs
+typedef std::function<void(DeusCommandType&)> TDeusConsoleFunc;
+typedef std::function<void(void*)> TDeusConsoleFuncVoid;
+typedef std::function<void(bool, const std::string&)> TDeusCommandCallback; // Success and output or error message
+typedef std::function<bool(std::string&)> TDeusTaskStep; // Does a slice of work appending any output, returns true once finished
+typedef std::function<TDeusTaskStep(DeusCommandType&)> TDeusTaskFunc;
+typedef std::unordered_map<DeusCVarName, const char*, DeusCVarNameHasher> DeusConsoleHelpTable;
+
+// Insert only hash table of nodes keyed by their name, safe to read from any thread without locking.
+// Slots are published with release stores and never change once set. Growing publishes a new version
+// of the slot array while readers may still probe the old one, retired versions are kept alive until the
+// table is destroyed so readers never see freed memory. Writers must be serialized by the caller
+template <typename T>
+class TDeusLockFreeTable {
+  private:
+    struct Slots {
+      size_t mask;
+      std::unique_ptr<std::atomic<T*>[]> items;
+
+      Slots(size_t capacity) : mask(capacity - 1), items(new std::atomic<T*>[capacity]) {
+        for (size_t i = 0; i < capacity; i++) {
+          this->items[i].store(NULL, std::memory_order_relaxed);
+        }
+      }
+    };
+
+    std::atomic<Slots*> current;
+    std::atomic<size_t> count;
+    std::vector<std::unique_ptr<Slots>> versions;
+    std::vector<std::unique_ptr<T>> nodes;
+
+    // Places a node in the first free slot of its probe sequence
+    static void place(Slots* slots, T* node) {
+      size_t i = node->name.hash & slots->mask;
+      while (slots->items[i].load(std::memory_order_relaxed) != NULL) {
+        i = (i + 1) & slots->mask;
+      }
+      slots->items[i].store(node, std::memory_order_release);
+    }
+
+  public:
+    TDeusLockFreeTable() : count(0) {
+      this->versions.emplace_back(new Slots(64));
+      this->current.store(this->versions.back().get(), std::memory_order_release);
+    }
+
+    TDeusLockFreeTable(const TDeusLockFreeTable&) = delete;
+    TDeusLockFreeTable& operator=(const TDeusLockFreeTable&) = delete;
+
+    // Finds a node by name, returns NULL if it doesnt exist
+    T* find(const DeusCVarName& name) const {
+      const Slots* slots = this->current.load(std::memory_order_acquire);
+      for (size_t i = name.hash & slots->mask;; i = (i + 1) & slots->mask) {
+        T* node = slots->items[i].load(std::memory_order_acquire);
+        if (node == NULL || node->name == name) {
+          return node;
+        }
+      }
+    }
+
+    // Takes ownership of a node and publishes it, the caller must hold the writer lock
+    // and make sure no node with that name exists
+    T* insert(std::unique_ptr<T> node) {
+      Slots* slots = this->current.load(std::memory_order_relaxed);
+      const size_t newCount = this->count.load(std::memory_order_relaxed) + 1;
+      if (newCount * 2 > slots->mask + 1) { // Keep load under half, publishing a larger version
+        Slots* grown = new Slots((slots->mask + 1) * 2);
+        this->versions.emplace_back(grown);
+        for (const std::unique_ptr<T>& existing : this->nodes) {
+          place(grown, existing.get());
+        }
+        this->current.store(grown, std::memory_order_release);
+        slots = grown;
+      }
+
+      T* published = node.get();
+      this->nodes.push_back(std::move(node));
+      place(slots, published);
+      this->count.store(newCount, std::memory_order_release);
+      return published;
+    }
+
+    size_t size() const {
+      return this->count.load(std::memory_order_acquire);
+    }
+};
+
+// Wrapper for console methods
+struct DeusConsoleMethod {
+  DeusCVarName name = DeusCVarName("", 0);
+  const char* description = "";
+  TDeusConsoleFunc func;
+  int flags = DEUS_METHOD_DEFAULT; // EDeusMethodFlags
+};
+
+// Operations on console variables of one type, shared by every variable of that type through TDeusCVarOps.
+// The table address also identifies the type, so no RTTI is needed to check handles
+struct DeusCVarOps {
+  uint8_t valueType; // EDeusValueType
+  uint8_t valueSize; // Size of arithmetic values, zero for anything else
+  void (*toString)(void* value, std::string& out);
+  void (*writeText)(void* value, std::string_view text); // Parses the text, throwing if it isnt valid for the type
+  void (*write)(void* value, const void* data); // Copies a value of the stored type, the wrapped type for atomics
+  void (*readInto)(void* value, void* out); // Arithmetic types only, copies the value out
+  void (*parseInto)(std::string_view text, void* out); // Arithmetic types only, parses without writing
+};
+
+// Wrapper for console variables and their flags, operations go through a static table for the value type
+struct DeusConsoleVariable {
+  DeusCVarName name = DeusCVarName("", 0);
+  const char* description = "";
+  const DeusCVarOps* ops = NULL;
+  void* value = NULL;
+  std::unique_ptr<TDeusConsoleFuncVoid> onUpdate; // Only allocated for variables with an update hook
+  int flags = DEUS_CVAR_DEFAULT;
+  uint32_t pendingIndex = DEUS_PENDING_NONE; // Slot in the pending frame writes, guarded by pendingMutex
+
+  // Calls the update hook if there is one
+  void fireUpdate() {
+    if (this->onUpdate) {
+      (*this->onUpdate)(this);
+    }
+  }
+};
+
+// Write staged while frame sync is enabled, published by IDeusConsoleManager::commitFrame
+struct DeusPendingWrite {
+  DeusConsoleVariable* variable = NULL;
+  std::string str; // Non-arithmetic values are kept as the token text
+  alignas(16) uint8_t value[16]; // Arithmetic values are parsed when staged
+  bool changed = false;
+};
+
+// Lower cases ASCII letters without going through the locale
+inline char deusFoldChar(char cChar) {
+  return cChar >= 'A' && cChar <= 'Z' ? (char)(cChar + ('a' - 'A')) : cChar;
+}
+
+// Folds a character into one of 32 classes for search prefilters: letters ignoring case, then digits and separators
+inline uint32_t deusCharBit(char cChar) {
+  const unsigned char c = (unsigned char)deusFoldChar(cChar);
+  if (c >= 'a' && c <= 'z') {
+    return 1u << (c - 'a');
+  } else if (c >= '0' && c <= '9') {
+    return 1u << 26;
+  } else if (c == '.') {
+    return 1u << 27;
+  } else if (c == '_') {
+    return 1u << 28;
+  } else if (c == ' ') {
+    return 1u << 29;
+  }
+  return 1u << 30;
+}
+
+// Bitmask of the character classes in a string, a query can only match text whose mask covers the query mask
+inline uint32_t deusCharMask(std::string_view str) {
+  uint32_t mask = 0;
+  for (const char cChar : str) {
+    mask |= deusCharBit(cChar);
+  }
+  return mask;
+}
+
+// Whether a character starts a word, after a separator or at a lower to upper case change
+inline bool deusIsWordStart(std::string_view text, size_t index) {
+  if (index == 0) {
+    return true;
+  }
+  const char prev = text[index - 1];
+  return prev == '.' || prev == '_' || prev == ' ' || prev == '-' || prev == '/' ||
+    (prev >= 'a' && prev <= 'z' && text[index] >= 'A' && text[index] <= 'Z');
+}
+
+// Scores text against a query matched as a case insensitive subsequence, -1 if it doesnt match.
+// The shortest window ending at the first full match is scored, so "count" prefers the last word of
+// "r.shadow.cascade.count" over letters scattered through it. Matches at word starts and runs of
+// consecutive characters score higher, skipped characters inside the window cost a little
+inline int deusFuzzyScore(std::string_view query, std::string_view text) {
+  if (query.empty() || query.size() > text.size()) {
+    return -1;
+  }
+
+  // Forward pass finds where the first full match ends
+  size_t end = 0;
+  size_t matched = 0;
+  for (; end < text.size() && matched < query.size(); end++) {
+    if (deusFoldChar(text[end]) == deusFoldChar(query[matched])) {
+      matched++;
+    }
+  }
+  if (matched < query.size()) {
+    return -1;
+  }
+
+  // Backward pass from there finds the latest start, tightening the window
+  size_t start = end;
+  for (size_t remaining = query.size(); remaining > 0; ) {
+    start--;
+    if (deusFoldChar(text[start]) == deusFoldChar(query[remaining - 1])) {
+      remaining--;
+    }
+  }
+
+  int score = start == 0 ? 8 : 0;
+  size_t queryIndex = 0;
+  size_t lastMatch = start;
+  for (size_t i = start; i < end && queryIndex < query.size(); i++) {
+    if (deusFoldChar(text[i]) != deusFoldChar(query[queryIndex])) {
+      continue;
+    }
+    score += 16;
+    if (deusIsWordStart(text, i)) {
+      score += 10;
+    }
+    if (queryIndex > 0) {
+      score += i == lastMatch + 1 ? 8 : -(int)std::min(i - lastMatch - 1, (size_t)8);
+    }
+    lastMatch = i;
+    queryIndex++;
+  }
+  return score;
+}
+
+// One result of a fuzzy search, higher scores are better matches, filled in by IDeusConsoleManager::search
+struct DeusSearchMatch {
+  std::string_view name;
+  const char* description;
+  int score;
+};
+
+// Matches text against a pattern where * matches any run of characters and ? any single character
+inline bool deusGlobMatch(std::string_view pattern, std::string_view text) {
+  size_t patternPos = 0;
+  size_t textPos = 0;
+  size_t starPos = std::string_view::npos;
+  size_t starText = 0;
+  while (textPos < text.size()) {
+    if (patternPos < pattern.size() && (pattern[patternPos] == '?' || pattern[patternPos] == text[textPos])) {
+      patternPos++;
+      textPos++;
+    } else if (patternPos < pattern.size() && pattern[patternPos] == '*') {
+      starPos = patternPos++;
+      starText = textPos;
+    } else if (starPos != std::string_view::npos) {
+      patternPos = starPos + 1;
+      textPos = ++starText;
+    } else {
+      return false;
+    }
+  }
+  while (patternPos < pattern.size() && pattern[patternPos] == '*') {
+    patternPos++;
+  }
+  return patternPos == pattern.size();
+}
+
+// Append only array split into fixed size chunks, so elements never move and each chunk is contiguous.
+// Writers must be serialized and publish the new size to readers themselves
+template <typename T>
+class TDeusChunkedArray {
+  private:
+    std::unique_ptr<std::unique_ptr<T[]>[]> chunks;
+
+  public:
+    static constexpr size_t chunkShift = 10;
+    static constexpr size_t chunkSize = (size_t)1 << chunkShift;
+    static constexpr size_t maxChunks = 1024;
+
+    // Stores a value at an index, allocating its chunk if this is the first index in it
+    void set(size_t index, const T& value) {
+      const size_t chunk = index >> chunkShift;
+      if (chunk >= maxChunks) {
+        throw DeusConsoleException("Console registry is full");
+      }
+      if (!this->chunks) {
+        this->chunks.reset(new std::unique_ptr<T[]>[maxChunks]);
+      }
+      if (!this->chunks[chunk]) {
+        this->chunks[chunk].reset(new T[chunkSize]);
+      }
+      this->chunks[chunk][index & (chunkSize - 1)] = value;
+    }
+
+    const T& operator[](size_t index) const {
+      return this->chunks[index >> chunkShift][index & (chunkSize - 1)];
+    }
+
+    // Returns the contiguous elements of a chunk
+    const T* chunk(size_t chunk) const {
+      return this->chunks[chunk].get();
+    }
+};
+
+// Registered variables and methods stored column by column in registration order. Indices are stable,
+// so full scans such as help, snapshots and flag queries stream through contiguous arrays of just the
+// fields they need rather than chasing nodes around the heap. Appends must be serialized by the caller,
+// readers on any thread see every entry below size()
+class DeusRegistryColumns {
+  private:
+    std::atomic<size_t> count{0};
+
+  public:
+    TDeusChunkedArray<std::string_view> names;
+    TDeusChunkedArray<uint64_t> hashes;
+    TDeusChunkedArray<const char*> descriptions;
+    TDeusChunkedArray<int> flags; // EDeusCVarFlags for variables, EDeusMethodFlags for methods
+    TDeusChunkedArray<uint8_t> types; // EDeusValueType, or DEUS_ENTRY_METHOD
+    TDeusChunkedArray<void*> values; // NULL for methods
+    TDeusChunkedArray<const DeusCVarOps*> ops; // NULL for methods
+    TDeusChunkedArray<uint32_t> nameMasks; // deusCharMask of names, for search prefilters
+    TDeusChunkedArray<uint32_t> descriptionMasks;
+    TDeusChunkedArray<std::string> defaults; // Variable values as text when registered, for resets
+
+    size_t size() const {
+      return this->count.load(std::memory_order_acquire);
+    }
+
+    // Adds an entry to every column then publishes it, returning its index
+    size_t append(DeusCVarName name, const char* description, int entryFlags, uint8_t type, void* value, const DeusCVarOps* entryOps, std::string defaultText = std::string()) {
+      const size_t index = this->count.load(std::memory_order_relaxed);
+      this->names.set(index, name.str);
+      this->hashes.set(index, name.hash);
+      this->descriptions.set(index, description);
+      this->flags.set(index, entryFlags);
+      this->types.set(index, type);
+      this->values.set(index, value);
+      this->ops.set(index, entryOps);
+      this->nameMasks.set(index, deusCharMask(name.str));
+      this->descriptionMasks.set(index, deusCharMask(description != NULL ? description : ""));
+      this->defaults.set(index, std::move(defaultText));
+      this->count.store(index + 1, std::memory_order_release);
+      return index;
+    }
+
+    // Calls a function with the index and length of each chunk of published entries
+    template <typename F>
+    void forEachChunk(F func) const {
+      const size_t total = this->size();
+      for (size_t first = 0, chunk = 0; first < total; first += TDeusChunkedArray<int>::chunkSize, chunk++) {
+        func(chunk, std::min(total - first, TDeusChunkedArray<int>::chunkSize));
+      }
+    }
+};
+
+// Prefix trie of registered names for completion. Children are kept sorted by character so a depth first walk
+// yields names in order, finding every name under a prefix costs the prefix length plus the size of the subtree.
+// Nodes live in one vector and refer to each other by index. Writers must be serialized with readers
+class DeusNameTrie {
+  private:
+    struct Node {
+      std::vector<std::pair<unsigned char, uint32_t>> children; // Sorted by character
+      uint32_t entry = DEUS_TRIE_NONE; // Registry index of the name ending at this node
+    };
+
+    std::vector<Node> nodes;
+
+    // Returns the child of a node for a character, or DEUS_TRIE_NONE
+    uint32_t child(uint32_t node, unsigned char cChar) const {
+      const std::vector<std::pair<unsigned char, uint32_t>>& children = this->nodes[node].children;
+      auto it = std::lower_bound(children.begin(), children.end(), std::make_pair(cChar, (uint32_t)0));
+      return it != children.end() && it->first == cChar ? it->second : DEUS_TRIE_NONE;
+    }
+
+  public:
+    DeusNameTrie() : nodes(1) {}
+
+    // Adds a name ending at a registry entry, a name that already exists keeps its first entry
+    void insert(std::string_view name, uint32_t entry) {
+      uint32_t node = 0;
+      for (const char nameChar : name) {
+        const unsigned char cChar = (unsigned char)nameChar;
+        uint32_t next = this->child(node, cChar);
+        if (next == DEUS_TRIE_NONE) {
+          next = (uint32_t)this->nodes.size();
+          this->nodes.emplace_back();
+          std::vector<std::pair<unsigned char, uint32_t>>& children = this->nodes[node].children;
+          children.insert(std::lower_bound(children.begin(), children.end(), std::make_pair(cChar, (uint32_t)0)), std::make_pair(cChar, next));
+        }
+        node = next;
+      }
+      if (this->nodes[node].entry == DEUS_TRIE_NONE) {
+        this->nodes[node].entry = entry;
+      }
+    }
+
+    // Returns the node reached by following a prefix from a node, the root by default, or DEUS_TRIE_NONE if no name continues with it
+    uint32_t find(std::string_view prefix, uint32_t node = 0) const {
+      for (size_t i = 0; i < prefix.size() && node != DEUS_TRIE_NONE; i++) {
+        node = this->child(node, (unsigned char)prefix[i]);
+      }
+      return node;
+    }
+
+    // Returns the registry entry of the name ending exactly at a node, or DEUS_TRIE_NONE
+    uint32_t entryAt(uint32_t node) const {
+      return this->nodes[node].entry;
+    }
+
+    // Counts how many characters past a node every name below it shares
+    size_t commonLength(uint32_t node) const {
+      size_t length = 0;
+      while (this->nodes[node].entry == DEUS_TRIE_NONE && this->nodes[node].children.size() == 1) {
+        node = this->nodes[node].children[0].second;
+        length++;
+      }
+      return length;
+    }
+
+    // Calls a function with the entry of every name below a node in sorted order, stopping once it returns false
+    template <typename F>
+    void forEachEntry(uint32_t node, F func) const {
+      std::vector<uint32_t> stack(1, node);
+      while (!stack.empty()) {
+        const Node& current = this->nodes[stack.back()];
+        stack.pop_back();
+        if (current.entry != DEUS_TRIE_NONE && !func(current.entry)) {
+          return;
+        }
+        for (size_t i = current.children.size(); i > 0; i--) {
+          stack.push_back(current.children[i - 1].second);
+        }
+      }
+    }
+};
+
+// Resolved handle to a console variable, obtained once with IDeusConsoleManager::findCVar
+// so that hot paths can read the value with a single pointer dereference
+template <typename T>
+class TDeusCVarRef {
+  private:
+    T* value;
+    DeusConsoleVariable* variable;
+
+  public:
+    TDeusCVarRef() : value(NULL), variable(NULL) {}
+    TDeusCVarRef(T* value, DeusConsoleVariable* variable) : value(value), variable(variable) {}
+
+    // Whether this handle points to a registered variable
+    bool isValid() const {
+      return this->value != NULL;
+    }
+
+    // Returns the variable flags, such as DEUS_CVAR_READONLY
+    int getFlags() const {
+      return this->variable->flags;
+    }
+
+    void set(T newValue) {
+      *this->value = newValue;
+    }
 
-// The parsed command containing tokens and a string for return value
-struct DeusCommandType {
-  char target[512];
-  size_t argc = 0;
-  std::vector<DeusCommandToken> tokens;
-  std::string returnStr;
-};
+    T& get() const {
+      return *this->value;
+    }
 
-// Readability typedefs
-typedef std::function<void(DeusCommandType&)> TDeusConsoleFunc;
-typedef std::function<std::string()> TDeusConsoleFuncToString;
-typedef std::function<void*()> TDeusConsoleFuncRead;
-typedef std::function<void(void*)> TDeusConsoleFuncVoid;
-typedef std::function<void(char*)> TDeusConsoleFuncWriteChar;
-typedef std::unordered_map<const char*, const char*> DeusConsoleHelpTable;
+    T& operator*() const {
+      return *this->value;
+    }
 
-// Wrapper for console variables and their flags/methods
-struct DeusConsoleVariable {
-  TDeusConsoleFuncVoid write;
-  TDeusConsoleFuncWriteChar writeIntFromBuffer;
-  TDeusConsoleFuncWriteChar writeDecimalFromBuffer;
-  TDeusConsoleFuncRead read;
-  TDeusConsoleFuncVoid onUpdate;
-  TDeusConsoleFuncToString toString;
-  int flags;
+    T* operator->() const {
+      return this->value;
+    }
 };
 
 // Checks if an input buffer of n length could be a numeric string
-inline int isNumericStr(char* str, size_t len) {
+inline int isNumericStr(const char* str, size_t len) {
   if (len == 0) {
     return 0;
   }
   bool hasPeriod = false;
-  for (int i = 0; i < len; i++) {
+  bool hasDigit = false;
+  for (size_t i = str[0] == '-' ? 1 : 0; i < len; i++) { // allow a leading minus sign
     char cChar = str[i];
+    hasDigit = hasDigit || isdigit(cChar);
     if (cChar == '.') { // check if is a decimal number
       if (hasPeriod) {
         return 0; // cannot be a numberic string with two periods
@@ -107,6 +1061,9 @@ inline int isNumericStr(char* str, size_t len) {
       return 0;
     }
   }
+  if (!hasDigit) {
+    return 0;
+  }
   return hasPeriod ? 2 : 1;
 }
 
@@ -129,13 +1086,445 @@ inline static void trimStr(char* str) {
   end[1] = '\0';
 }
 
+// Splits a command into whitespace separated tokens, yielding slices of the input without copying.
+// Quoted strings are yielded as a single token without their quotes. Holds no shared state, so
+// any number of threads can tokenize at once
+struct DeusCommandTokenizer {
+  std::string_view input;
+  size_t pos = 0;
+
+  DeusCommandTokenizer(std::string_view input) : input(input) {}
+
+  // Reads the next token, returning false once the input is exhausted
+  bool next(std::string_view& token, bool& isQuoted) {
+    const size_t length = this->input.size();
+    while (this->pos < length && isspace((unsigned char)this->input[this->pos])) {
+      this->pos++;
+    }
+    if (this->pos >= length) {
+      return false;
+    }
+
+    // Quoted strings run until the matching quote followed by whitespace or the end of input
+    const char quote = this->input[this->pos];
+    isQuoted = quote == '\'' || quote == '"';
+    if (isQuoted) {
+      const size_t start = this->pos + 1;
+      size_t end = start;
+      while (end < length && !(this->input[end] == quote && (end + 1 == length || isspace((unsigned char)this->input[end + 1])))) {
+        end++;
+      }
+      if (end >= length) {
+        throw DeusConsoleException("Unterminated string in command");
+      }
+      token = this->input.substr(start, end - start);
+      this->pos = end + 1;
+      return true;
+    }
+
+    const size_t start = this->pos;
+    while (this->pos < length && !isspace((unsigned char)this->input[this->pos])) {
+      this->pos++;
+    }
+    token = this->input.substr(start, this->pos - start);
+    return true;
+  }
+};
+
+// Splits input into statements separated by ';' or newlines, separators inside quoted strings are ignored
+// and '//' comments at the start of a token run to the end of the line, so values such as URLs keep theirs.
+// Statements are yielded as slices of the input without surrounding whitespace, empty statements are skipped
+struct DeusCommandSplitter {
+  std::string_view input;
+  size_t pos = 0;
+  size_t line = 1; // Line the last yielded statement started on
+  size_t nextLine = 1;
+
+  DeusCommandSplitter(std::string_view input) : input(input) {}
+
+  // Reads the next statement, returning false once the input is exhausted
+  bool next(std::string_view& statement) {
+    const size_t length = this->input.size();
+    while (this->pos < length) {
+      const size_t start = this->pos;
+      this->line = this->nextLine;
+      char quote = 0;
+      size_t end = start;
+      size_t commentStart = length;
+      for (; end < length; end++) {
+        const char cChar = this->input[end];
+        if (cChar == '\n') { // Newlines always end a statement, even an unterminated string
+          this->nextLine++;
+          break;
+        } else if (commentStart < length) {
+          continue;
+        } else if (quote != 0) { // Quoted strings end on their quote followed by whitespace or a separator
+          const char nextChar = end + 1 < length ? this->input[end + 1] : 0;
+          if (cChar == quote && (nextChar == 0 || nextChar == ';' || isspace((unsigned char)nextChar))) {
+            quote = 0;
+          }
+        } else if (cChar == ';') {
+          break;
+        } else if (cChar == '/' && end + 1 < length && this->input[end + 1] == '/' && (end == start || isspace((unsigned char)this->input[end - 1]))) {
+          commentStart = end;
+        } else if ((cChar == '\'' || cChar == '"') && (end == start || isspace((unsigned char)this->input[end - 1]))) {
+          quote = cChar;
+        }
+      }
+      this->pos = end < length ? end + 1 : length;
+      if (commentStart < end) {
+        end = commentStart;
+      }
+
+      // Trim surrounding whitespace and skip empty statements
+      size_t first = start;
+      size_t last = end;
+      while (first < last && isspace((unsigned char)this->input[first])) {
+        first++;
+      }
+      while (last > first && isspace((unsigned char)this->input[last - 1])) {
+        last--;
+      }
+      if (last > first) {
+        statement = this->input.substr(first, last - first);
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+// Outcome of one command run as part of a batch, its output is a slice of the batch output
+struct DeusBatchEntry {
+  size_t outputOffset = 0;
+  size_t outputLength = 0;
+  size_t line = 0;
+  bool success = true;
+};
+
+// Results of running a batch of commands. Every command appends to the same output buffer,
+// so reusing a result across batches avoids allocating per command
+struct DeusBatchResult {
+  std::string output;
+  std::vector<DeusBatchEntry> entries;
+  size_t errorCount = 0;
+  double elapsedMs = 0.0; // Total time spent running the batch
+
+  // Returns the output or error message of a command
+  std::string_view getOutput(size_t index) const {
+    const DeusBatchEntry& entry = this->entries[index];
+    return std::string_view(this->output).substr(entry.outputOffset, entry.outputLength);
+  }
+
+  void clear() {
+    this->output.clear();
+    this->entries.clear();
+    this->errorCount = 0;
+    this->elapsedMs = 0.0;
+  }
+};
+
+// Bounded lock free queue of command text, any number of threads can push while the owner pops.
+// Each slot carries a sequence number that tells producers and the consumer whose turn it is,
+// so pushing is a single compare and swap and neither side ever waits on a lock
+class DeusCommandQueue {
+  private:
+    struct Slot {
+      std::atomic<size_t> sequence;
+      uint16_t length;
+      char text[DEUS_COMMAND_MAX_LENGTH];
+      TDeusCommandCallback callback;
+    };
+
+    static_assert((DEUS_COMMAND_QUEUE_CAPACITY & (DEUS_COMMAND_QUEUE_CAPACITY - 1)) == 0, "Command queue capacity must be a power of two");
+    static constexpr size_t mask = DEUS_COMMAND_QUEUE_CAPACITY - 1;
+
+    std::unique_ptr<Slot[]> slots;
+    alignas(64) std::atomic<size_t> pushPos{0};
+    alignas(64) std::atomic<size_t> popPos{0};
+
+  public:
+    DeusCommandQueue() : slots(new Slot[DEUS_COMMAND_QUEUE_CAPACITY]) {
+      for (size_t i = 0; i < DEUS_COMMAND_QUEUE_CAPACITY; i++) {
+        this->slots[i].sequence.store(i, std::memory_order_relaxed);
+      }
+    }
+
+    // Copies a command into the queue, returns false if the queue is full
+    bool push(std::string_view command, TDeusCommandCallback&& callback) {
+      if (command.size() >= DEUS_COMMAND_MAX_LENGTH) {
+        throw DeusConsoleException("Input command buffer is too large, cannot queue.");
+      }
+
+      // Claim a slot, a sequence behind the position means the consumer hasnt freed it yet
+      size_t pos = this->pushPos.load(std::memory_order_relaxed);
+      Slot* slot;
+      for (;;) {
+        slot = &this->slots[pos & mask];
+        const intptr_t diff = (intptr_t)slot->sequence.load(std::memory_order_acquire) - (intptr_t)pos;
+        if (diff == 0) {
+          if (this->pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            break;
+          }
+        } else if (diff < 0) {
+          return false;
+        } else {
+          pos = this->pushPos.load(std::memory_order_relaxed);
+        }
+      }
+
+      // Fill the slot and publish it to the consumer
+      memcpy(slot->text, command.data(), command.size());
+      slot->text[command.size()] = 0;
+      slot->length = (uint16_t)command.size();
+      slot->callback = std::move(callback);
+      slot->sequence.store(pos + 1, std::memory_order_release);
+      return true;
+    }
+
+    // Copies the oldest command into a buffer of DEUS_COMMAND_MAX_LENGTH bytes, returns false if the queue is empty
+    bool pop(char* command, TDeusCommandCallback& callback) {
+      size_t pos = this->popPos.load(std::memory_order_relaxed);
+      Slot* slot;
+      for (;;) {
+        slot = &this->slots[pos & mask];
+        const intptr_t diff = (intptr_t)slot->sequence.load(std::memory_order_acquire) - (intptr_t)(pos + 1);
+        if (diff == 0) {
+          if (this->popPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            break;
+          }
+        } else if (diff < 0) {
+          return false;
+        } else {
+          pos = this->popPos.load(std::memory_order_relaxed);
+        }
+      }
+
+      // Take the slot contents then hand it back to producers for the next lap
+      memcpy(command, slot->text, slot->length + 1);
+      callback = std::move(slot->callback);
+      slot->callback = NULL;
+      slot->sequence.store(pos + DEUS_COMMAND_QUEUE_CAPACITY, std::memory_order_release);
+      return true;
+    }
+
+    // Approximate number of queued commands, exact only when no other thread is pushing or popping
+    size_t size() const {
+      const size_t pushed = this->pushPos.load(std::memory_order_acquire);
+      const size_t popped = this->popPos.load(std::memory_order_acquire);
+      return pushed > popped ? pushed - popped : 0;
+    }
+};
+
+// Commands waiting in the scheduler, ordered by when they are due then by when they were scheduled
+struct DeusScheduledCommand {
+  uint64_t due = 0; // Frame number or steady clock nanoseconds
+  uint64_t order = 0;
+  std::string commands;
+
+  // Heap comparison, the earliest command ends up at the top
+  static bool later(const DeusScheduledCommand& a, const DeusScheduledCommand& b) {
+    return a.due > b.due || (a.due == b.due && a.order > b.order);
+  }
+};
+
+// Long running method started by a command, resumed by IDeusConsoleManager::tick until its step returns true
+struct DeusRunningTask {
+  std::string name;
+  TDeusTaskStep step;
+  bool done = false;
+};
+
+// Thread safe method call from a batch, run on the worker pool. Its output or error is left in command.returnStr
+struct DeusParallelCommand {
+  DeusCommandType command;
+  size_t line = 0;
+  bool success = true;
+};
+
+// Small work stealing thread pool. Each worker has its own deque, jobs are handed out round robin and a worker
+// that runs dry steals from the front of the others. Threads waiting on jobs can help through runOne
+class DeusWorkerPool {
+  private:
+    struct WorkerQueue {
+      std::deque<std::function<void()>> jobs;
+      std::mutex mutex;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> queuedCount{0};
+    std::atomic<size_t> nextQueue{0};
+    std::mutex sleepMutex;
+    std::condition_variable wakeCondition;
+    bool stopping = false;
+
+    void workerLoop(size_t index) {
+      for (;;) {
+        if (this->runOne(index)) {
+          continue;
+        }
+        std::unique_lock<std::mutex> lock(this->sleepMutex);
+        this->wakeCondition.wait(lock, [this]() {
+          return this->stopping || this->queuedCount.load(std::memory_order_acquire) > 0;
+        });
+        if (this->stopping && this->queuedCount.load(std::memory_order_acquire) == 0) {
+          return;
+        }
+      }
+    }
+
+  public:
+    DeusWorkerPool(size_t threadCount) {
+      for (size_t i = 0; i < threadCount; i++) {
+        this->queues.emplace_back(new WorkerQueue());
+      }
+      for (size_t i = 0; i < threadCount; i++) {
+        this->threads.emplace_back(&DeusWorkerPool::workerLoop, this, i);
+      }
+    }
+
+    // Finishes queued jobs then joins the workers
+    ~DeusWorkerPool() {
+      {
+        std::lock_guard<std::mutex> lock(this->sleepMutex);
+        this->stopping = true;
+      }
+      this->wakeCondition.notify_all();
+      for (std::thread& thread : this->threads) {
+        thread.join();
+      }
+    }
+
+    size_t size() const {
+      return this->threads.size();
+    }
+
+    // Queues a job on the next worker
+    void submit(std::function<void()> job) {
+      WorkerQueue& queue = *this->queues[this->nextQueue.fetch_add(1, std::memory_order_relaxed) % this->queues.size()];
+      {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+      }
+      {
+        // Publish under the sleep lock so a worker checking for jobs cant miss the wake up
+        std::lock_guard<std::mutex> lock(this->sleepMutex);
+        this->queuedCount.fetch_add(1, std::memory_order_release);
+      }
+      this->wakeCondition.notify_one();
+    }
+
+    // Runs one job, newest first from the preferred queue or oldest first from any other.
+    // Returns false if every queue was empty
+    bool runOne(size_t preferred = 0) {
+      std::function<void()> job;
+      const size_t queueCount = this->queues.size();
+      for (size_t i = 0; i < queueCount && !job; i++) {
+        WorkerQueue& queue = *this->queues[(preferred + i) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) {
+          continue;
+        }
+        if (i == 0) {
+          job = std::move(queue.jobs.back());
+          queue.jobs.pop_back();
+        } else {
+          job = std::move(queue.jobs.front());
+          queue.jobs.pop_front();
+        }
+      }
+      if (!job) {
+        return false;
+      }
+      this->queuedCount.fetch_sub(1, std::memory_order_acq_rel);
+      job();
+      return true;
+    }
+};
+
+// Read only view of a whole file, memory mapped where supported and read into memory otherwise
+class DeusMappedFile {
+  private:
+    const char* data = NULL;
+    size_t size = 0;
+#if DEUS_CONSOLE_MMAP
+    void* mapping = NULL;
+#else
+    std::vector<char> contents;
+#endif
+
+  public:
+    DeusMappedFile(const char* path) {
+#if DEUS_CONSOLE_MMAP
+      const int fd = open(path, O_RDONLY);
+      if (fd < 0) {
+        throw DeusConsoleException("Cannot open file: " + (std::string)path);
+      }
+      struct stat fileStat;
+      if (fstat(fd, &fileStat) != 0) {
+        close(fd);
+        throw DeusConsoleException("Cannot read file: " + (std::string)path);
+      }
+      this->size = (size_t)fileStat.st_size;
+      if (this->size > 0) {
+        this->mapping = mmap(NULL, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (this->mapping == MAP_FAILED) {
+          this->mapping = NULL;
+          close(fd);
+          throw DeusConsoleException("Cannot map file: " + (std::string)path);
+        }
+        this->data = static_cast<const char*>(this->mapping);
+      }
+      close(fd);
+#else
+      FILE* file = fopen(path, "rb");
+      if (file == NULL) {
+        throw DeusConsoleException("Cannot open file: " + (std::string)path);
+      }
+      fseek(file, 0, SEEK_END);
+      const long fileSize = ftell(file);
+      fseek(file, 0, SEEK_SET);
+      this->contents.resize(fileSize > 0 ? (size_t)fileSize : 0);
+      this->size = fread(this->contents.data(), 1, this->contents.size(), file);
+      this->data = this->contents.data();
+      fclose(file);
+#endif
+    }
+
+    ~DeusMappedFile() {
+#if DEUS_CONSOLE_MMAP
+      if (this->mapping != NULL) {
+        munmap(this->mapping, this->size);
+      }
+#endif
+    }
+
+    DeusMappedFile(const DeusMappedFile&) = delete;
+    DeusMappedFile& operator=(const DeusMappedFile&) = delete;
+
+    std::string_view view() const {
+      return std::string_view(this->data, this->size);
+    }
+};
+
 // Default helper implementation to convert type to string
 // if you register custom types, you will need to create an override
 // like below. See std::string and const char* representations
 template <typename T>
 struct TConsoleTypeHelper {
   static std::string toString(T& val) {
-    return std::to_string(val);
+    char buffer[64];
+    return std::string(buffer, deusFormatNumber(val, buffer, sizeof(buffer)));
+  }
+};
+
+// Convert atomic values to string by loading them first
+template <typename T>
+struct TConsoleTypeHelper<std::atomic<T>> {
+  static std::string toString(std::atomic<T>& val) {
+    T value = val.load(std::memory_order_acquire);
+    return TConsoleTypeHelper<T>::toString(value);
   }
 };
 
@@ -155,38 +1544,444 @@ struct TConsoleTypeHelper<std::string> {
   }
 };
 
+// Static operations table for console variables of a type, see DeusCVarOps
+template <typename T>
+struct TDeusCVarOps {
+  typedef typename TDeusAtomicTraits<T>::ValueType TValue;
+  static constexpr bool isNumeric = std::is_arithmetic_v<TValue>;
+  static_assert(!TDeusAtomicTraits<T>::isAtomic || isNumeric, "Atomic console variables must wrap an arithmetic type");
+
+  static void toString(void* value, std::string& out) {
+    if constexpr (isNumeric) {
+      TValue current;
+      readInto(value, &current);
+      char buffer[64];
+      out.assign(buffer, deusFormatNumber(current, buffer, sizeof(buffer)));
+    } else if constexpr (std::is_same_v<T, std::string>) {
+      out = *static_cast<std::string*>(value);
+    } else {
+      out = TConsoleTypeHelper<T>::toString(*static_cast<T*>(value));
+    }
+  }
+
+  // Values that dont fit the type are rejected rather than truncated
+  static void writeText(void* value, std::string_view text) {
+    if constexpr (isNumeric) {
+      const TValue parsed = deusParseNumber<TValue>(text);
+      write(value, &parsed);
+    } else if constexpr (std::is_assignable_v<T&, std::string>) {
+      *static_cast<T*>(value) = std::string(text);
+    } else {
+      throw DeusConsoleException("Console variable cannot be written from text");
+    }
+  }
+
+  // Atomic stores use release ordering so readers on other threads that load with acquire ordering
+  // also see anything written before the value changed
+  static void write(void* value, const void* data) {
+    if constexpr (TDeusAtomicTraits<T>::isAtomic) {
+      static_cast<T*>(value)->store(*static_cast<const TValue*>(data), std::memory_order_release);
+    } else if constexpr (std::is_copy_assignable_v<T>) {
+      *static_cast<T*>(value) = *static_cast<const T*>(data);
+    } else {
+      throw DeusConsoleException("Console variable cannot be copied");
+    }
+  }
+
+  static void readInto(void* value, void* out) {
+    if constexpr (TDeusAtomicTraits<T>::isAtomic) {
+      *static_cast<TValue*>(out) = static_cast<T*>(value)->load(std::memory_order_acquire);
+    } else if constexpr (isNumeric) {
+      *static_cast<TValue*>(out) = *static_cast<T*>(value);
+    }
+  }
+
+  static void parseInto(std::string_view text, void* out) {
+    if constexpr (isNumeric) {
+      *static_cast<TValue*>(out) = deusParseNumber<TValue>(text);
+    }
+  }
+
+  static constexpr DeusCVarOps table = {
+    deusValueType<T>(),
+    isNumeric ? (uint8_t)sizeof(TValue) : (uint8_t)0,
+    &toString,
+    &writeText,
+    &write,
+    isNumeric ? &readInto : NULL,
+    isNumeric ? &parseInto : NULL,
+  };
+};
+
+
+
+// Argument and return types of a callable, used to generate typed console methods
+template <typename F>
+struct TDeusCallableTraits : TDeusCallableTraits<decltype(&F::operator())> {};
+
+template <typename R, typename... Args>
+struct TDeusCallableTraits<R(*)(Args...)> {
+  typedef R ReturnType;
+  typedef std::tuple<std::decay_t<Args>...> ArgsTuple;
+  static constexpr size_t arity = sizeof...(Args);
+};
+
+template <typename C, typename R, typename... Args>
+struct TDeusCallableTraits<R(C::*)(Args...)> : TDeusCallableTraits<R(*)(Args...)> {};
+
+template <typename C, typename R, typename... Args>
+struct TDeusCallableTraits<R(C::*)(Args...) const> : TDeusCallableTraits<R(*)(Args...)> {};
+
+// Converts a command token into an argument of a typed console method
+template <typename T>
+struct TDeusArgParser {
+  static_assert(std::is_arithmetic_v<T>, "Typed console method arguments must be arithmetic, std::string, std::string_view or const char*");
+  static constexpr const char* typeName = std::is_same_v<T, bool> ? "a bool" : (std::is_integral_v<T> ? "an integer" : "a number");
+
+  static T parse(const DeusCommandToken& token) {
+    return deusParseNumber<T>(std::string_view(token.str, token.length));
+  }
+};
+
+template <>
+struct TDeusArgParser<std::string_view> {
+  static constexpr const char* typeName = "a string";
+
+  static std::string_view parse(const DeusCommandToken& token) {
+    return std::string_view(token.str, token.length);
+  }
+};
+
+template <>
+struct TDeusArgParser<std::string> {
+  static constexpr const char* typeName = "a string";
+
+  static std::string parse(const DeusCommandToken& token) {
+    return std::string(token.str, token.length);
+  }
+};
+
+template <>
+struct TDeusArgParser<const char*> {
+  static constexpr const char* typeName = "a string";
 
+  static const char* parse(const DeusCommandToken& token) {
+    return token.str;
+  }
+};
 
 // Class to manage all console variables and commands
 // Does not do any input processing
 class IDeusConsoleManager {
   private:
-    std::unordered_map<const char*, DeusConsoleVariable> variableTable;
-    std::unordered_map<const char*, TDeusConsoleFunc> methodTable;
-    DeusConsoleHelpTable helpTable;
+    // Tables are keyed by name content, so a lookup is a single hash probe. Names view the
+    // pointer supplied at registration, which must outlive the registration. Lookups are lock free
+    // and safe from any thread, registrations are serialized by registryMutex
+    TDeusLockFreeTable<DeusConsoleVariable> variableTable;
+    TDeusLockFreeTable<DeusConsoleMethod> methodTable;
+    DeusRegistryColumns registry; // Every entry in registration order, for scans
+    DeusNameTrie nameTrie; // Names for completion, guarded by registryMutex
+    std::mutex registryMutex;
+
+    // Writes staged while frame sync is enabled, double buffered so commands can keep staging
+    // writes for the next frame while the current one is being published
+    std::atomic<bool> frameSync{false};
+    std::vector<DeusPendingWrite> pendingWrites;
+    std::vector<DeusPendingWrite> committingWrites;
+    std::mutex pendingMutex;
+    std::mutex commitMutex;
+
+    // Commands submitted from other threads, run by drainQueue
+    DeusCommandQueue commandQueue;
+
+    // Delayed commands are kept in min heaps by due frame and due time, so a tick only touches
+    // the commands that expire. Guarded by scheduleMutex, commands run with it unlocked
+    std::vector<DeusScheduledCommand> frameSchedule;
+    std::vector<DeusScheduledCommand> timeSchedule;
+    uint64_t currentFrame = 0;
+    uint64_t scheduleOrder = 0;
+    std::mutex scheduleMutex;
+
+    // Long running methods, tasks started by commands are appended under taskMutex and moved
+    // to steppingTasks while tick resumes them so steps run unlocked
+    std::vector<DeusRunningTask> tasks;
+    std::vector<DeusRunningTask> steppingTasks;
+    std::mutex taskMutex;
+
+    // Runs thread safe methods from batches in parallel, NULL until setWorkerCount is called
+    std::unique_ptr<DeusWorkerPool> workerPool;
+
+    static uint64_t steadyNowNs() {
+      return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
 
-    // Gets a variable reference by name
-    DeusConsoleVariable& getVariable(const char* name) {
-      for (auto kv : this->variableTable) {
-        if (strcmp(kv.first, name) == 0) {
-          return this->variableTable[kv.first];
+    // Adds a command to a schedule heap, scheduleMutex must be held
+    void pushScheduled(std::vector<DeusScheduledCommand>& schedule, uint64_t due, std::string_view commands) {
+      schedule.emplace_back();
+      DeusScheduledCommand& scheduled = schedule.back();
+      scheduled.due = due;
+      scheduled.order = this->scheduleOrder++;
+      scheduled.commands.assign(commands.data(), commands.size());
+      std::push_heap(schedule.begin(), schedule.end(), DeusScheduledCommand::later);
+    }
+
+    // Takes the earliest command off a schedule heap if it is due and was scheduled before orderLimit,
+    // so commands scheduled while ticking wait for a later tick. scheduleMutex must be held
+    static bool popScheduled(std::vector<DeusScheduledCommand>& schedule, uint64_t now, uint64_t orderLimit, DeusScheduledCommand& out) {
+      if (schedule.empty() || schedule.front().due > now || schedule.front().order >= orderLimit) {
+        return false;
+      }
+      std::pop_heap(schedule.begin(), schedule.end(), DeusScheduledCommand::later);
+      out = std::move(schedule.back());
+      schedule.pop_back();
+      return true;
+    }
+
+    // Parses one argument of a typed console method, naming the argument and expected type if it cant be converted
+    template <typename T>
+    static T parseTypedArg(const DeusCommandType& cmd, size_t index) {
+      try {
+        return TDeusArgParser<T>::parse(cmd.tokens[index]);
+      } catch (const DeusConsoleException& e) {
+        throw DeusConsoleException("Argument " + std::to_string(index + 1) + " of " + cmd.target + " must be " + TDeusArgParser<T>::typeName + ": " + e.what());
+      }
+    }
+
+    // Checks the argument count, converts every argument and calls a typed console method. Arguments are
+    // converted left to right, a returned value is formatted into the command output
+    template <typename F, size_t... I>
+    static void invokeTyped(F& func, DeusCommandType& cmd, std::index_sequence<I...>) {
+      typedef TDeusCallableTraits<F> Traits;
+      typedef typename Traits::ArgsTuple Args;
+      if (cmd.argc != sizeof...(I)) {
+        throw DeusConsoleException((std::string)cmd.target + " expects " + std::to_string(sizeof...(I)) + (sizeof...(I) == 1 ? " argument" : " arguments") + ", got " + std::to_string(cmd.argc));
+      }
+
+      Args args{ parseTypedArg<std::tuple_element_t<I, Args>>(cmd, I)... };
+      typedef typename Traits::ReturnType TReturn;
+      if constexpr (std::is_void_v<TReturn>) {
+        std::apply(func, std::move(args));
+      } else if constexpr (std::is_arithmetic_v<TReturn>) {
+        char buffer[64];
+        const TReturn value = std::apply(func, std::move(args));
+        cmd.returnStr.assign(buffer, deusFormatNumber(value, buffer, sizeof(buffer)));
+      } else {
+        static_assert(std::is_convertible_v<TReturn, std::string_view>, "Typed console methods must return void, an arithmetic type or a string");
+        const TReturn value = std::apply(func, std::move(args));
+        cmd.returnStr.assign(std::string_view(value));
+      }
+    }
+
+    // Whether a parsed command calls a thread safe method that can run on the worker pool
+    bool isParallelCommand(const DeusCommandType& commandResult) {
+      if (!this->workerPool) {
+        return false;
+      }
+      const DeusCVarName cmdTarget((const char*)commandResult.target);
+      const DeusConsoleMethod* method = this->findMethod(cmdTarget);
+      return method != NULL && (method->flags & DEUS_METHOD_THREADSAFE) && this->findVariable(cmdTarget) == NULL;
+    }
+
+    // Copies a parsed command into the batch's parallel commands and queues it on the worker pool
+    void submitParallel(const DeusCommandType& commandResult, size_t line, std::deque<DeusParallelCommand>& parallelCommands, std::atomic<size_t>& remaining) {
+      parallelCommands.emplace_back();
+      DeusParallelCommand& parallel = parallelCommands.back();
+      parallel.command = commandResult;
+      parallel.line = line;
+      remaining.fetch_add(1, std::memory_order_relaxed);
+      this->workerPool->submit([this, &parallel, &remaining]() {
+        try {
+          this->runParsedCommand(parallel.command);
+        } catch (const std::exception& e) {
+          parallel.success = false;
+          parallel.command.returnStr = e.what();
+        }
+        remaining.fetch_sub(1, std::memory_order_release);
+      });
+    }
+
+    // Waits for parallel commands to finish, running pool jobs on this thread in the meantime
+    void waitParallel(std::atomic<size_t>& remaining) {
+      while (remaining.load(std::memory_order_acquire) > 0) {
+        if (!this->workerPool->runOne()) {
+          std::this_thread::yield();
+        }
+      }
+    }
+
+    // Waits for a batch's parallel commands and appends their results in submission order.
+    // Returns false if one failed and the batch should stop
+    bool finishParallel(std::deque<DeusParallelCommand>& parallelCommands, std::atomic<size_t>& remaining, DeusBatchResult& result, bool stopOnError) {
+      if (parallelCommands.empty()) {
+        return true;
+      }
+      this->waitParallel(remaining);
+
+      bool failed = false;
+      for (DeusParallelCommand& parallel : parallelCommands) {
+        DeusBatchEntry entry;
+        entry.outputOffset = result.output.size();
+        entry.outputLength = parallel.command.returnStr.size();
+        entry.line = parallel.line;
+        entry.success = parallel.success;
+        result.output += parallel.command.returnStr;
+        result.entries.push_back(entry);
+        if (!parallel.success) {
+          result.errorCount++;
+          failed = true;
+        }
+      }
+      parallelCommands.clear();
+      return !(failed && stopOnError);
+    }
+
+    // Handles the wait and waitms script keywords, which defer the rest of the input by a number of frames
+    // (one by default) or milliseconds. Returns true if the statement was a wait
+    bool deferRemainder(DeusCommandType& commandResult, const DeusCommandSplitter& splitter) {
+      const std::string_view target = commandResult.target;
+      const bool waitFrames = target == "wait";
+      if (!waitFrames && target != "waitms") {
+        return false;
+      }
+      if (commandResult.argc > 1 || (!waitFrames && commandResult.argc == 0)) {
+        throw DeusConsoleException(waitFrames ? "wait takes an optional frame count" : "waitms requires a delay in milliseconds");
+      }
+
+      const std::string_view remainder = splitter.input.substr(splitter.pos);
+      if (waitFrames) {
+        const uint32_t frames = commandResult.argc == 1 ? deusParseNumber<uint32_t>(commandResult.tokens[0].str) : 1;
+        this->scheduleCommand(remainder, frames);
+      } else {
+        this->scheduleCommandMs(remainder, deusParseNumber<double>(commandResult.tokens[0].str));
+      }
+      return true;
+    }
+
+    // Whether a registry entry is a variable included in snapshots and text exports
+    static bool isSnapshotted(int flags, uint8_t type) {
+      return !(flags & DEUS_CVAR_READONLY) && type != DEUS_VALUE_CUSTOM && type != DEUS_ENTRY_METHOD;
+    }
+
+    // Appends raw bytes to a snapshot buffer
+    static void appendSnapshotBytes(std::vector<uint8_t>& snapshot, const void* data, size_t size) {
+      const uint8_t* bytes = static_cast<const uint8_t*>(data);
+      snapshot.insert(snapshot.end(), bytes, bytes + size);
+    }
+
+    // Finds a variable by name, returns NULL if it doesnt exist
+    DeusConsoleVariable* findVariable(DeusCVarName name) {
+      return this->variableTable.find(name);
+    }
+
+    // Finds a method by name, returns NULL if it doesnt exist
+    DeusConsoleMethod* findMethod(DeusCVarName name) {
+      return this->methodTable.find(name);
+    }
+
+    // Returns the staged write of a variable, adding one if it has none. pendingMutex must be held
+    DeusPendingWrite& pendingWriteFor(DeusConsoleVariable& variable) {
+      if (variable.pendingIndex == DEUS_PENDING_NONE) {
+        variable.pendingIndex = (uint32_t)this->pendingWrites.size();
+        this->pendingWrites.emplace_back();
+        this->pendingWrites.back().variable = &variable;
+      }
+      return this->pendingWrites[variable.pendingIndex];
+    }
+
+    // Stages a write to be published at the next commitFrame, later writes to the same variable
+    // replace earlier ones. Arithmetic values are parsed here so invalid input still throws immediately
+    void stageWrite(DeusConsoleVariable& variable, const DeusCommandToken& token) {
+      alignas(16) uint8_t parsedValue[16];
+      const DeusCVarOps& ops = *variable.ops;
+      if (ops.parseInto) {
+        ops.parseInto(std::string_view(token.str, token.length), parsedValue);
+      }
+
+      std::lock_guard<std::mutex> lock(this->pendingMutex);
+      DeusPendingWrite& pending = this->pendingWriteFor(variable);
+      if (ops.parseInto) {
+        memcpy(pending.value, parsedValue, ops.valueSize);
+      } else {
+        pending.str.assign(token.str, token.length);
+      }
+    }
+
+    // Collects the registry entries in a namespace, sorted by name. A plain name such as "net" or "net." matches
+    // itself and everything under "net.", a pattern with wildcards such as "r.*.count" walks the trie below its
+    // literal prefix. Either way only that subtree is visited
+    void collectNamespace(std::string_view pattern, std::vector<uint32_t>& entries) {
+      entries.clear();
+      const size_t wildcard = pattern.find_first_of("*?");
+      const DeusRegistryColumns& registry = this->registry;
+      std::lock_guard<std::mutex> lock(this->registryMutex);
+      if (wildcard == std::string_view::npos) {
+        if (pattern.size() > 1 && pattern.back() == '.') {
+          pattern.remove_suffix(1);
+        }
+        uint32_t node = this->nameTrie.find(pattern);
+        if (node != DEUS_TRIE_NONE && !pattern.empty()) {
+          if (this->nameTrie.entryAt(node) != DEUS_TRIE_NONE) {
+            entries.push_back(this->nameTrie.entryAt(node));
+          }
+          node = this->nameTrie.find(".", node);
+        }
+        if (node != DEUS_TRIE_NONE) {
+          this->nameTrie.forEachEntry(node, [&entries](uint32_t entry) {
+            entries.push_back(entry);
+            return true;
+          });
         }
+        return;
+      }
+
+      const uint32_t node = this->nameTrie.find(pattern.substr(0, wildcard));
+      if (node != DEUS_TRIE_NONE) {
+        this->nameTrie.forEachEntry(node, [&registry, &entries, pattern](uint32_t entry) {
+          if (deusGlobMatch(pattern, registry.names[entry])) {
+            entries.push_back(entry);
+          }
+          return true;
+        });
+      }
+    }
+
+    // Sets a registered variable back to the value it had when registered, returning false for constants and
+    // custom types. Goes through the same path as a console write so frame sync and update hooks apply
+    bool resetEntry(uint32_t entry) {
+      const DeusRegistryColumns& registry = this->registry;
+      if (!isSnapshotted(registry.flags[entry], registry.types[entry])) {
+        return false;
+      }
+      DeusConsoleVariable& variable = *this->findVariable(DeusCVarName(registry.names[entry], registry.hashes[entry]));
+      const std::string& defaultText = registry.defaults[entry];
+      if (this->frameSync.load(std::memory_order_relaxed)) {
+        DeusCommandToken token;
+        token.str = defaultText.c_str();
+        token.length = (uint16_t)defaultText.size();
+        this->stageWrite(variable, token);
+      } else {
+        variable.ops->writeText(variable.value, defaultText);
+        variable.fireUpdate();
+      }
+      return true;
+    }
+
+    // Gets a variable reference by name
+    DeusConsoleVariable& getVariable(DeusCVarName name) {
+      DeusConsoleVariable* variable = this->findVariable(name);
+      if (variable == NULL) {
+        throw DeusConsoleException("Console variable does not exist: " + (std::string)(name.str));
       }
-
-      throw DeusConsoleException("Console variable does not exist: " + (std::string)(name));
-      return this->variableTable[name];
+      return *variable;
     }
 
     // Gets a method function object reference by name
-    TDeusConsoleFunc& getMethod(const char* name) {
-      for (auto kv : this->methodTable) {
-        if (strcmp(kv.first, name) == 0) {
-          return this->methodTable[kv.first];
-        }
+    TDeusConsoleFunc& getMethod(DeusCVarName name) {
+      DeusConsoleMethod* method = this->findMethod(name);
+      if (method == NULL) {
+        throw DeusConsoleException("Console method does not exist: " + (std::string)(name.str));
       }
-
-      throw DeusConsoleException("Console method does not exist: " + (std::string)(name));
-      return this->methodTable[name];
+      return method->func;
     }
 
   public:
@@ -195,201 +1990,684 @@ class IDeusConsoleManager {
     // Binds base commands that may be useful, call as an initializer
     void bindBaseCommands() {
       this->registerMethod("help", [this](DeusCommandType& cmd) {
-        std::string result = "Method/variable list:\n";
-        for (auto kv : this->helpTable) {
-          result += (std::string)(kv.first) + "\t\t" + (std::string)(kv.second) + "\n";
+        const std::string_view header = "Method/variable list:\n";
+        auto writeEntry = [&cmd](std::string_view name, const char* description) {
+          cmd.write(name);
+          cmd.write("\t\t");
+          cmd.write(description);
+          cmd.write("\n");
+        };
+        if (cmd.argc > 0) { // Only a namespace or pattern, such as help net or help r.*
+          cmd.write(header);
+          this->forEachInNamespace(std::string_view(cmd.tokens[0].str, cmd.tokens[0].length), writeEntry);
+          return;
+        }
+
+        // Without a sink everything lands in returnStr, so size it up front to avoid reallocating
+        if (cmd.output == NULL) {
+          size_t resultLength = header.size();
+          this->forEachHelp([&resultLength](std::string_view name, const char* description) {
+            resultLength += name.size() + strlen(description) + 3;
+          });
+          cmd.returnStr.reserve(resultLength);
+        }
+        cmd.write(header);
+        this->forEachHelp(writeEntry);
+      }, "Returns a list of variables/methods and their descriptions, optionally only those in a namespace");
+
+      this->registerMethod("list", [this](DeusCommandType& cmd) {
+        // Variables are listed with their values, methods by name
+        std::vector<uint32_t> entries;
+        this->collectNamespace(cmd.argc > 0 ? std::string_view(cmd.tokens[0].str, cmd.tokens[0].length) : std::string_view(), entries);
+        std::string valueStr;
+        for (const uint32_t entry : entries) {
+          cmd.write(this->registry.names[entry]);
+          if (this->registry.types[entry] != DEUS_ENTRY_METHOD) {
+            this->registry.ops[entry]->toString(this->registry.values[entry], valueStr);
+            cmd.write(" = ");
+            cmd.write(valueStr);
+          }
+          cmd.write("\n");
+        }
+      }, "Lists variables with their values and methods, optionally only those in a namespace such as test or test.*");
+
+      this->registerMethod("reset", [this](DeusCommandType& cmd) {
+        if (cmd.argc != 1) {
+          throw DeusConsoleException("reset requires a namespace or pattern");
+        }
+        const size_t resetCount = this->resetNamespace(std::string_view(cmd.tokens[0].str, cmd.tokens[0].length));
+        cmd.write("Reset ");
+        cmd.write(std::to_string(resetCount));
+        cmd.write(" variables");
+      }, "Resets variables in a namespace or matching a pattern, such as r.shadow.*, to their registered values");
+
+      this->registerMethod("exec", [this](DeusCommandType& cmd) {
+        if (cmd.argc != 1) {
+          throw DeusConsoleException("exec requires a file path");
+        }
+
+        // Report failed lines followed by a summary
+        const char* path = cmd.tokens[0].str;
+        DeusBatchResult result;
+        this->execFile(path, result);
+        for (size_t i = 0; i < result.entries.size(); i++) {
+          if (!result.entries[i].success) {
+            cmd.write(path);
+            cmd.write(":");
+            cmd.write(std::to_string(result.entries[i].line));
+            cmd.write(": ");
+            cmd.write(result.getOutput(i));
+            cmd.write("\n");
+          }
+        }
+        char elapsedStr[64];
+        const double elapsedMs = (double)(int64_t)(result.elapsedMs * 1000.0) / 1000.0;
+        cmd.write("Executed ");
+        cmd.write(std::to_string(result.entries.size()));
+        cmd.write(" commands from ");
+        cmd.write(path);
+        cmd.write(" in ");
+        cmd.write(std::string_view(elapsedStr, deusFormatNumber(elapsedMs, elapsedStr, sizeof(elapsedStr))));
+        cmd.write("ms with ");
+        cmd.write(std::to_string(result.errorCount));
+        cmd.write(" errors");
+      }, "Executes a script file of commands");
+    }
+
+    // Calls a function with the name and description of every registered method and variable, in registration order
+    template <typename F>
+    void forEachHelp(F func) {
+      const DeusRegistryColumns& registry = this->registry;
+      registry.forEachChunk([&registry, &func](size_t chunk, size_t length) {
+        const std::string_view* names = registry.names.chunk(chunk);
+        const char* const* descriptions = registry.descriptions.chunk(chunk);
+        for (size_t i = 0; i < length; i++) {
+          func(names[i], descriptions[i]);
         }
-        cmd.returnStr = result;
-      }, "Returns a list of variables/methods and their descriptions");
+      });
     }
 
-    // Returns a reference to the help table itself, useful for iterating over potential cmds
-    DeusConsoleHelpTable& getHelpTable() {
-      return this->helpTable;
+    // Collects the names of variables that have every one of the given flags, in registration order.
+    // Only the flag and type columns are scanned, so the loop stays tight with many variables
+    void findVariablesWithFlags(int requiredFlags, std::vector<std::string_view>& names) {
+      const DeusRegistryColumns& registry = this->registry;
+      names.clear();
+      registry.forEachChunk([&registry, &names, requiredFlags](size_t chunk, size_t length) {
+        const int* flags = registry.flags.chunk(chunk);
+        const uint8_t* types = registry.types.chunk(chunk);
+        for (size_t i = 0; i < length; i++) {
+          if ((flags[i] & requiredFlags) == requiredFlags && types[i] != DEUS_ENTRY_METHOD) {
+            names.push_back(registry.names.chunk(chunk)[i]);
+          }
+        }
+      });
     }
 
-    // Returns help text for a specific variable or method
-    const char* getHelp(const char* key) {
-      return this->helpTable[key];
+    // Calls a function with the name and description of every method and variable in a namespace, sorted by name.
+    // The pattern is a namespace such as "net", or has wildcards such as "r.shadow.*" or "*.count"
+    template <typename F>
+    void forEachInNamespace(std::string_view pattern, F func) {
+      std::vector<uint32_t> entries;
+      this->collectNamespace(pattern, entries);
+      for (const uint32_t entry : entries) {
+        func(this->registry.names[entry], this->registry.descriptions[entry]);
+      }
     }
 
-    // Checks whether a variable with that name exists in the table
-    bool variableExists(const char* name) {
-      for (auto kv : this->variableTable) {
-        if (strcmp(kv.first, name) == 0) {
-          return true;
+    // Sets every writable variable in a namespace back to its registered value, returning how many were reset
+    size_t resetNamespace(std::string_view pattern) {
+      std::vector<uint32_t> entries;
+      this->collectNamespace(pattern, entries);
+      size_t resetCount = 0;
+      for (const uint32_t entry : entries) {
+        if (this->resetEntry(entry)) {
+          resetCount++;
         }
       }
-      return false;
+      return resetCount;
     }
 
-    // Checks whether a method with that name exists in the table
-    bool methodExists(const char* name) {
-      for (auto kv : this->methodTable) {
-        if (strcmp(kv.first, name) == 0) {
-          return true;
+    // Finds the best fuzzy matches for a query among registered names and descriptions, best first, up to maxMatches.
+    // Name matches outrank description matches. Character class masks rule out most entries four at a time
+    // before any text is touched, and a bounded heap keeps only the best so far
+    void search(std::string_view query, std::vector<DeusSearchMatch>& matches, size_t maxMatches = 10) {
+      matches.clear();
+      if (query.empty() || maxMatches == 0) {
+        return;
+      }
+
+      auto isBetter = [](const DeusSearchMatch& a, const DeusSearchMatch& b) {
+        if (a.score != b.score) {
+          return a.score > b.score;
+        } else if (a.name.size() != b.name.size()) {
+          return a.name.size() < b.name.size();
+        }
+        return a.name < b.name;
+      };
+
+      const DeusRegistryColumns& registry = this->registry;
+      const uint32_t queryMask = deusCharMask(query);
+      registry.forEachChunk([&](size_t chunk, size_t length) {
+        const uint32_t* nameMasks = registry.nameMasks.chunk(chunk);
+        const uint32_t* descriptionMasks = registry.descriptionMasks.chunk(chunk);
+
+        // Scores an entry that passed the prefilter, keeping the worst of the best at the front of the heap
+        auto consider = [&](size_t i) {
+          const std::string_view name = registry.names.chunk(chunk)[i];
+          const char* description = registry.descriptions.chunk(chunk)[i];
+          int score = (nameMasks[i] & queryMask) == queryMask ? deusFuzzyScore(query, name) : -1;
+          if (score < 0 && description != NULL && (descriptionMasks[i] & queryMask) == queryMask) {
+            score = deusFuzzyScore(query, description) / 2;
+          }
+          if (score < 0) {
+            return;
+          }
+
+          const DeusSearchMatch match = { name, description, score };
+          if (matches.size() < maxMatches) {
+            matches.push_back(match);
+            std::push_heap(matches.begin(), matches.end(), isBetter);
+          } else if (isBetter(match, matches.front())) {
+            std::pop_heap(matches.begin(), matches.end(), isBetter);
+            matches.back() = match;
+            std::push_heap(matches.begin(), matches.end(), isBetter);
+          }
+        };
+
+        size_t i = 0;
+#if DEUS_CONSOLE_SSE2
+        const __m128i queryBits = _mm_set1_epi32((int)queryMask);
+        for (; i + 4 <= length; i += 4) {
+          const __m128i nameBits = _mm_and_si128(_mm_loadu_si128((const __m128i*)(nameMasks + i)), queryBits);
+          const __m128i descriptionBits = _mm_and_si128(_mm_loadu_si128((const __m128i*)(descriptionMasks + i)), queryBits);
+          const __m128i hits = _mm_or_si128(_mm_cmpeq_epi32(nameBits, queryBits), _mm_cmpeq_epi32(descriptionBits, queryBits));
+          const int hitBits = _mm_movemask_ps(_mm_castsi128_ps(hits));
+          for (int lane = 0; hitBits != 0 && lane < 4; lane++) {
+            if (hitBits & (1 << lane)) {
+              consider(i + lane);
+            }
+          }
+        }
+#endif
+        for (; i < length; i++) {
+          if ((nameMasks[i] & queryMask) == queryMask || (descriptionMasks[i] & queryMask) == queryMask) {
+            consider(i);
+          }
         }
+      });
+
+      std::sort_heap(matches.begin(), matches.end(), isBetter);
+    }
+
+    // Returns a copy of the help table, useful for iterating over potential cmds
+    DeusConsoleHelpTable getHelpTable() {
+      DeusConsoleHelpTable helpTable;
+      this->forEachHelp([&helpTable](std::string_view name, const char* description) {
+        helpTable.emplace(name, description);
+      });
+      return helpTable;
+    }
+
+    // Finds registered method and variable names starting with a prefix, sorted, up to maxMatches of them.
+    // Returns the longest prefix shared by every match, empty if nothing matched
+    std::string_view complete(std::string_view prefix, std::vector<std::string_view>& matches, size_t maxMatches = SIZE_MAX) {
+      matches.clear();
+      std::lock_guard<std::mutex> lock(this->registryMutex);
+      const uint32_t node = this->nameTrie.find(prefix);
+      if (node == DEUS_TRIE_NONE) {
+        return std::string_view();
       }
-      return false;
+
+      const DeusRegistryColumns& registry = this->registry;
+      this->nameTrie.forEachEntry(node, [&registry, &matches, maxMatches](uint32_t entry) {
+        if (matches.size() >= maxMatches) {
+          return false;
+        }
+        matches.push_back(registry.names[entry]);
+        return true;
+      });
+      return matches.empty() ? std::string_view() : matches[0].substr(0, prefix.size() + this->nameTrie.commonLength(node));
+    }
+
+    // Returns help text for a specific variable or method, NULL if it isnt registered
+    const char* getHelp(DeusCVarName key) {
+      const DeusConsoleVariable* variable = this->findVariable(key);
+      if (variable != NULL) {
+        return variable->description;
+      }
+      const DeusConsoleMethod* method = this->findMethod(key);
+      return method != NULL ? method->description : NULL;
+    }
+
+    // Checks whether a variable with that name exists in the table
+    bool variableExists(DeusCVarName name) {
+      return this->findVariable(name) != NULL;
+    }
+
+    // Checks whether a method with that name exists in the table
+    bool methodExists(DeusCVarName name) {
+      return this->findMethod(name) != NULL;
+    }
+
+    // Registers a long running method. When the command runs, func is called with the parsed command and returns
+    // a step function, which tick calls repeatedly within its time budget until the step returns true.
+    // Output appended by each step is streamed to the tick result, so long commands dont stall a frame
+    void registerTask(DeusCVarName name, TDeusTaskFunc func, const char* description = "") {
+      this->registerMethod(name, [this, func = std::move(func)](DeusCommandType& cmd) {
+        DeusRunningTask task;
+        task.name = cmd.target;
+        task.step = func(cmd);
+        if (task.step) {
+          std::lock_guard<std::mutex> lock(this->taskMutex);
+          this->tasks.push_back(std::move(task));
+        }
+      }, description);
+    }
+
+    // Registers a callable with typed arguments, such as [](int a, float b, std::string_view c). The argument count
+    // check and conversions are generated at compile time and mistakes throw with the argument and expected type.
+    // Arithmetic and string return values become the command output
+    template <typename F, std::enable_if_t<!std::is_invocable_v<F&, DeusCommandType&>> * = nullptr>
+    void registerMethod(DeusCVarName name, F func, const char* description = "", int flags = DEUS_METHOD_DEFAULT) {
+      static_assert(TDeusCallableTraits<F>::arity <= DEUS_COMMAND_MAX_TOKENS, "Typed console methods take at most DEUS_COMMAND_MAX_TOKENS arguments");
+      this->registerMethod(name, TDeusConsoleFunc([func = std::move(func)](DeusCommandType& cmd) mutable {
+        invokeTyped(func, cmd, std::make_index_sequence<TDeusCallableTraits<F>::arity>());
+      }), description, flags);
     }
 
     // Registers a void function object that takes DeusCommandType as its only argument
-    void registerMethod(const char* name, TDeusConsoleFunc func, const char* description = "") {
-      if (this->methodTable.find(name) == this->methodTable.end()) {
-        this->methodTable[name] = func;
-        this->helpTable[name] = description;
+    void registerMethod(DeusCVarName name, TDeusConsoleFunc func, const char* description = "", int flags = DEUS_METHOD_DEFAULT) {
+      std::lock_guard<std::mutex> lock(this->registryMutex);
+      if (this->findMethod(name) == NULL) {
+        std::unique_ptr<DeusConsoleMethod> method(new DeusConsoleMethod());
+        method->name = name;
+        method->description = description;
+        method->func = std::move(func);
+        method->flags = flags;
+        const size_t entry = this->registry.append(name, description, flags, DEUS_ENTRY_METHOD, NULL, NULL);
+        this->nameTrie.insert(name.str, (uint32_t)entry);
+        this->methodTable.insert(std::move(method));
       }
     }
 
     // This method will take a name, value reference, help description and flags for a console variable
     // and will assign it to the various tables required for reading/writing/remembering arguments
     template <typename T>
-    void registerCVar(const char* name, T& value, const char* description = "", int flags = DEUS_CVAR_DEFAULT, TDeusConsoleFuncVoid onUpdate = NULL) {
+    void registerCVar(DeusCVarName name, T& value, const char* description = "", int flags = DEUS_CVAR_DEFAULT, TDeusConsoleFuncVoid onUpdate = NULL) {
       // Skip registration if flag defined
       if (flags & DEUS_CVAR_UNREGISTERED) {
         return;
       }
 
       // Don't register if already exists
-      if (this->variableTable.find(name) == this->variableTable.end()) {
-        DeusConsoleVariable variable;
-        variable.flags = flags;
-        variable.read = [&value]() {
-          return &value;
-        };
-        variable.onUpdate = onUpdate;
-        variable.toString = [&value]() {
-          return TConsoleTypeHelper<T>::toString(value);
-        };
-        if (!(flags & DEUS_CVAR_READONLY)) {
-          this->bindWriteMethods(value, variable);
+      std::lock_guard<std::mutex> lock(this->registryMutex);
+      if (this->findVariable(name) == NULL) {
+        std::unique_ptr<DeusConsoleVariable> variable(new DeusConsoleVariable());
+        variable->name = name;
+        variable->description = description;
+        variable->flags = flags | (TDeusAtomicTraits<T>::isAtomic ? DEUS_CVAR_ATOMIC : 0);
+        variable->ops = &TDeusCVarOps<T>::table;
+        variable->value = &value;
+        if (onUpdate) {
+          variable->onUpdate.reset(new TDeusConsoleFuncVoid(std::move(onUpdate)));
         }
-        this->variableTable[name] = variable;
-        this->helpTable[name] = description;
+        std::string defaultText;
+        variable->ops->toString(&value, defaultText);
+        const size_t entry = this->registry.append(name, description, variable->flags, variable->ops->valueType, &value, variable->ops, std::move(defaultText));
+        this->nameTrie.insert(name.str, (uint32_t)entry);
+        this->variableTable.insert(std::move(variable));
       }
     }
 
-    // Write methods for arithmetic types
-    template <typename T, std::enable_if_t<std::is_arithmetic_v<std::remove_reference_t<T>>> * = nullptr> inline
-    void bindWriteMethods(T& value, DeusConsoleVariable& variable) {
-      variable.writeDecimalFromBuffer = [&value](char* data) {
-        T tokenValue = atof(data);
-        value = tokenValue;
-      };
-      variable.writeIntFromBuffer = [&value](char* data) {
-        T tokenValue = atol(data);
-        value = tokenValue;
-      };
-      variable.write = [&value](void* data) {
-        value = *static_cast<T*>(data);
-      };
+    // This method will take the ptr of the value and cast to its native type as a reference
+    template <typename T>
+    T& getCVar(DeusCVarName name) {
+      return *static_cast<T*>(this->getVariable(name).value);
     }
 
-    // Write methods for non-arithmetic types
-    template <typename T, std::enable_if_t<!std::is_arithmetic_v<std::remove_reference_t<T>>> * = nullptr> inline
-    void bindWriteMethods(T& value, DeusConsoleVariable& variable) {
-      variable.write = [&value](void* data) {
-        value = *static_cast<T*>(data);
-      };
+    // Writes every writable variable into a compact binary snapshot of name hashes and typed values.
+    // Values are stored in native byte order, so snapshots are meant to be restored by the same build
+    void saveSnapshot(std::vector<uint8_t>& snapshot) {
+      uint32_t count = 0;
+      snapshot.clear();
+      appendSnapshotBytes(snapshot, DEUS_SNAPSHOT_MAGIC, 4);
+      appendSnapshotBytes(snapshot, &count, sizeof(count));
+      const DeusRegistryColumns& registry = this->registry;
+      registry.forEachChunk([&registry, &snapshot, &count](size_t chunk, size_t length) {
+        const int* flags = registry.flags.chunk(chunk);
+        const uint8_t* types = registry.types.chunk(chunk);
+        for (size_t i = 0; i < length; i++) {
+          if (!isSnapshotted(flags[i], types[i])) {
+            continue;
+          }
+
+          // Records are the name hash, name length and bytes, value type, value size and value bytes
+          alignas(16) uint8_t valueBuffer[16];
+          const void* value = valueBuffer;
+          void* variableValue = registry.values.chunk(chunk)[i];
+          const DeusCVarOps& ops = *registry.ops.chunk(chunk)[i];
+          uint32_t valueSize = ops.valueSize;
+          if (types[i] == DEUS_VALUE_STRING) {
+            const std::string& str = *static_cast<const std::string*>(variableValue);
+            value = str.data();
+            valueSize = (uint32_t)str.size();
+          } else {
+            ops.readInto(variableValue, valueBuffer);
+          }
+          const std::string_view name = registry.names.chunk(chunk)[i];
+          const uint16_t nameLength = (uint16_t)name.size();
+          appendSnapshotBytes(snapshot, &registry.hashes.chunk(chunk)[i], sizeof(uint64_t));
+          appendSnapshotBytes(snapshot, &nameLength, sizeof(uint16_t));
+          appendSnapshotBytes(snapshot, name.data(), nameLength);
+          appendSnapshotBytes(snapshot, &types[i], sizeof(uint8_t));
+          appendSnapshotBytes(snapshot, &valueSize, sizeof(uint32_t));
+          appendSnapshotBytes(snapshot, value, valueSize);
+          count++;
+        }
+      });
+      memcpy(snapshot.data() + 4, &count, sizeof(count));
     }
 
-    // This method will take the ptr of the value and cast to its native type as a reference
+    // Restores variables from a binary snapshot in a single pass, firing update hooks of values that changed.
+    // Records for unknown, readonly or retyped variables are skipped, names are compared as well as hashes so a
+    // colliding name never restores into the wrong variable. With frame sync enabled values are staged like any
+    // other write and published by commitFrame. Returns the number of variables restored
+    size_t restoreSnapshot(const uint8_t* data, size_t size) {
+      uint32_t count = 0;
+      if (size < 8 || memcmp(data, DEUS_SNAPSHOT_MAGIC, 4) != 0) {
+        throw DeusConsoleException("Invalid console snapshot");
+      }
+      memcpy(&count, data + 4, sizeof(count));
+
+      size_t pos = 8;
+      size_t restored = 0;
+      const size_t headerSize = sizeof(uint8_t) + sizeof(uint32_t);
+      for (uint32_t i = 0; i < count; i++) {
+        uint64_t hash;
+        uint16_t nameLength;
+        uint8_t valueType;
+        uint32_t valueSize;
+        if (pos + sizeof(hash) + sizeof(nameLength) > size) {
+          throw DeusConsoleException("Console snapshot is truncated");
+        }
+        memcpy(&hash, data + pos, sizeof(hash));
+        memcpy(&nameLength, data + pos + sizeof(hash), sizeof(nameLength));
+        pos += sizeof(hash) + sizeof(nameLength);
+        if (pos + nameLength + headerSize > size) {
+          throw DeusConsoleException("Console snapshot is truncated");
+        }
+        const DeusCVarName name(std::string_view(reinterpret_cast<const char*>(data + pos), nameLength), hash);
+        pos += nameLength;
+        memcpy(&valueType, data + pos, sizeof(valueType));
+        memcpy(&valueSize, data + pos + sizeof(valueType), sizeof(valueSize));
+        pos += headerSize;
+        if (pos + valueSize > size) {
+          throw DeusConsoleException("Console snapshot is truncated");
+        }
+        const uint8_t* valueData = data + pos;
+        pos += valueSize;
+
+        // Find the variable and make sure it still has the same type
+        DeusConsoleVariable* foundVariable = this->variableTable.find(name);
+        if (foundVariable == NULL) {
+          continue;
+        }
+        DeusConsoleVariable& variable = *foundVariable;
+        const DeusCVarOps& ops = *variable.ops;
+        if (!isSnapshotted(variable.flags, ops.valueType) || ops.valueType != valueType) {
+          continue;
+        }
+        if (valueType != DEUS_VALUE_STRING && (valueSize != ops.valueSize || (valueType == DEUS_VALUE_BOOL && valueData[0] > 1))) {
+          continue;
+        }
+
+        // Frame synced restores are staged, commitFrame applies them and fires the update hooks
+        if (this->frameSync.load(std::memory_order_relaxed)) {
+          std::lock_guard<std::mutex> lock(this->pendingMutex);
+          DeusPendingWrite& pending = this->pendingWriteFor(variable);
+          if (valueType == DEUS_VALUE_STRING) {
+            pending.str.assign(reinterpret_cast<const char*>(valueData), valueSize);
+          } else {
+            memcpy(pending.value, valueData, valueSize);
+          }
+          restored++;
+          continue;
+        }
+
+        bool changed = false;
+        if (valueType == DEUS_VALUE_STRING) {
+          std::string& str = *static_cast<std::string*>(variable.value);
+          changed = str.size() != valueSize || memcmp(str.data(), valueData, valueSize) != 0;
+          if (changed) {
+            str.assign(reinterpret_cast<const char*>(valueData), valueSize);
+          }
+        } else {
+          // Go through the variable's operations so atomic values are loaded and stored atomically
+          alignas(16) uint8_t currentValue[16];
+          alignas(16) uint8_t restoredValue[16];
+          ops.readInto(variable.value, currentValue);
+          memcpy(restoredValue, valueData, valueSize);
+          changed = memcmp(currentValue, restoredValue, valueSize) != 0;
+          if (changed) {
+            ops.write(variable.value, restoredValue);
+          }
+        }
+
+        restored++;
+        if (changed) {
+          variable.fireUpdate();
+        }
+      }
+      return restored;
+    }
+
+    size_t restoreSnapshot(const std::vector<uint8_t>& snapshot) {
+      return this->restoreSnapshot(snapshot.data(), snapshot.size());
+    }
+
+    // Picks a quote that a string value can be wrapped in and still parse back unchanged, 0 if there is none.
+    // Commands have no escapes, so a quote inside the value must not be followed by whitespace, a separator or
+    // the closing quote, and newlines always end a statement
+    static char exportQuote(std::string_view str) {
+      if (str.find('\n') != std::string_view::npos) {
+        return 0;
+      }
+      for (const char quote : { '\'', '"' }) {
+        bool usable = true;
+        for (size_t i = str.find(quote); usable && i != std::string_view::npos; i = str.find(quote, i + 1)) {
+          usable = i + 1 < str.size() && str[i + 1] != ';' && !isspace((unsigned char)str[i + 1]);
+        }
+        if (usable) {
+          return quote;
+        }
+      }
+      return 0;
+    }
+
+    // Writes every writable variable as a command on its own line, the output can be run with exec or runBatch.
+    // String values that cant be written as a command, such as ones with newlines, an unusable quote or that are
+    // too long, are left out with a comment line naming the variable instead
+    void exportText(std::string& output) {
+      std::string valueStr;
+      const DeusRegistryColumns& registry = this->registry;
+      registry.forEachChunk([&registry, &output, &valueStr](size_t chunk, size_t length) {
+        const int* flags = registry.flags.chunk(chunk);
+        const uint8_t* types = registry.types.chunk(chunk);
+        for (size_t i = 0; i < length; i++) {
+          if (!isSnapshotted(flags[i], types[i])) {
+            continue;
+          }
+
+          void* value = registry.values.chunk(chunk)[i];
+          const std::string_view name = registry.names.chunk(chunk)[i];
+          if (types[i] == DEUS_VALUE_STRING) {
+            const std::string& str = *static_cast<const std::string*>(value);
+            const char quote = exportQuote(str);
+            if (quote == 0 || name.size() + str.size() + 3 >= DEUS_COMMAND_MAX_LENGTH) {
+              output.append("// ").append(name).append(" skipped, its value cant be written as a command\n");
+              continue;
+            }
+            output.append(name).append(" ");
+            output.append(1, quote).append(str).append(1, quote);
+          } else {
+            registry.ops.chunk(chunk)[i]->toString(value, valueStr);
+            output.append(name).append(" ").append(valueStr);
+          }
+          output.append("\n");
+        }
+      });
+    }
+
+    // Enables or disables frame sync. While enabled, console writes are staged rather than applied
+    // so every system sees the same values for a whole frame, they are published by commitFrame.
+    // Disabling publishes anything still pending
+    void setFrameSync(bool enabled) {
+      this->frameSync.store(enabled, std::memory_order_relaxed);
+      if (!enabled) {
+        this->commitFrame();
+      }
+    }
+
+    bool isFrameSync() const {
+      return this->frameSync.load(std::memory_order_relaxed);
+    }
+
+    // Returns the number of variables with writes waiting for the next commitFrame
+    size_t pendingCount() {
+      std::lock_guard<std::mutex> lock(this->pendingMutex);
+      return this->pendingWrites.size();
+    }
+
+    // Publishes writes staged since the last call, only the latest write to each variable is applied.
+    // Every value is written before any update hook fires, hooks fire once per variable that changed.
+    // Returns the number of variables that changed
+    size_t commitFrame() {
+      std::lock_guard<std::mutex> commitLock(this->commitMutex);
+      {
+        // Swap buffers so writes made by update hooks are staged for the next frame
+        std::lock_guard<std::mutex> lock(this->pendingMutex);
+        this->committingWrites.swap(this->pendingWrites);
+        for (DeusPendingWrite& pending : this->committingWrites) {
+          pending.variable->pendingIndex = DEUS_PENDING_NONE;
+        }
+      }
+
+      size_t changedCount = 0;
+      for (DeusPendingWrite& pending : this->committingWrites) {
+        DeusConsoleVariable& variable = *pending.variable;
+        const DeusCVarOps& ops = *variable.ops;
+        if (ops.parseInto) {
+          alignas(16) uint8_t currentValue[16];
+          ops.readInto(variable.value, currentValue);
+          pending.changed = memcmp(currentValue, pending.value, ops.valueSize) != 0;
+          if (pending.changed) {
+            ops.write(variable.value, pending.value);
+          }
+        } else {
+          pending.changed = ops.valueType != DEUS_VALUE_STRING || *static_cast<std::string*>(variable.value) != pending.str;
+          if (pending.changed) {
+            try {
+              ops.writeText(variable.value, pending.str);
+            } catch (const DeusConsoleException&) { // Custom types that cant be written from text are left as they were
+              pending.changed = false;
+            }
+          }
+        }
+        changedCount += pending.changed ? 1 : 0;
+      }
+
+      for (DeusPendingWrite& pending : this->committingWrites) {
+        if (pending.changed) {
+          pending.variable->fireUpdate();
+        }
+      }
+      this->committingWrites.clear();
+      return changedCount;
+    }
+
+    // Resolves a variable into a typed handle that stays valid for the lifetime of the console,
+    // throws if the variable doesnt exist or was registered with a different type
     template <typename T>
-    T& getCVar(const char* name) {
+    TDeusCVarRef<T> findCVar(DeusCVarName name) {
       DeusConsoleVariable& variable = this->getVariable(name);
-      TDeusConsoleFuncRead& readFunc = variable.read;
-      return *static_cast<T*>(readFunc());
+      if (variable.ops != &TDeusCVarOps<T>::table) {
+        throw DeusConsoleException("Console variable type mismatch: " + (std::string)(name.str));
+      }
+      return TDeusCVarRef<T>(static_cast<T*>(variable.value), &variable);
     }
 
     // Parses an input string by splitting it into tokens by whitespace characters returning
     // a method or variable name, supplied arguments and types for those arguments
-    DeusCommandType parseCommand(const char* inputCmd, DeusCommandType& commandResult) {
-      if (strlen(inputCmd) >= 256) {
+    DeusCommandType& parseCommand(const char* inputCmd, DeusCommandType& commandResult) {
+      return this->parseCommand(std::string_view(inputCmd), commandResult);
+    }
+
+    // Parses a single command from a slice of a larger buffer, see above
+    DeusCommandType& parseCommand(std::string_view inputCmd, DeusCommandType& commandResult) {
+      const size_t inputLength = inputCmd.size();
+      if (inputLength >= DEUS_COMMAND_MAX_LENGTH) {
         throw DeusConsoleException("Input command buffer is too large, cannot parse.");
       }
 
-      // Copy input buffer into workable memory
-      char command[512];
-      strcpy(command, inputCmd);
-
-      // Trim whitespace from command
-      trimStr(command);
+      // Copy input into the command so tokens can be null terminated in place
+      char* buffer = commandResult.buffer;
+      memcpy(buffer, inputCmd.data(), inputLength);
+      buffer[inputLength] = 0;
+      commandResult.returnStr.clear();
+
+      // First token is always the target
+      DeusCommandTokenizer tokenizer(std::string_view(buffer, inputLength));
+      std::string_view cmdToken;
+      bool isQuoted = false;
+      size_t targetLength = 0;
+      commandResult.target = "";
+      commandResult.tokens.clear();
+      if (tokenizer.next(cmdToken, isQuoted)) {
+        commandResult.target = cmdToken.data();
+        targetLength = cmdToken.size();
+      }
 
-      // Split string into tokens
-      const char* whitespaceStr = " ";
-      bool isStringParsing = false;
-      char* cmdToken = strtok(command, whitespaceStr);
+      // Remaining tokens are arguments, more than the allowed token count is an error rather than dropped
       DeusCommandToken commandToken;
-      bool isFirstToken = true;
-      while (cmdToken != NULL) {
-        if (isFirstToken) { // First token is always the target
-          strcpy(commandResult.target, cmdToken);
-          isFirstToken = false;
+      while (commandResult.tokens.size() < DEUS_COMMAND_MAX_TOKENS && tokenizer.next(cmdToken, isQuoted)) {
+        if (isQuoted) {
+          commandToken.type = DEUS_VARTYPE_STRING;
+        } else if (cmdToken == "true") {
+          commandToken.type = DEUS_VARTYPE_BOOL_TRUE;
+          cmdToken = "1";
+        } else if (cmdToken == "false") {
+          commandToken.type = DEUS_VARTYPE_BOOL_FALSE;
+          cmdToken = "0";
         } else {
-          // Detect if boolean true/false strings
-          const bool isBoolPositive = !isStringParsing && strcmp(cmdToken, "true") == 0;
-          const bool isBoolNegative = !isStringParsing && strcmp(cmdToken, "false") == 0;
-          if (isBoolPositive) {
-            commandToken.type = DEUS_VARTYPE_BOOL_TRUE;
-            strcpy(commandToken.str, "1");
-          } else if (isBoolNegative) {
-            commandToken.type = DEUS_VARTYPE_BOOL_FALSE;
-            strcpy(commandToken.str, "0");
-          } else {
-            const size_t tokenLength = strlen(cmdToken);
-            const bool isStringStart = !isStringParsing && (cmdToken[0] == '\'' || cmdToken[0] == '"');
-            const bool isStringEnd = isStringParsing && (cmdToken[tokenLength - 1] == '\'' || cmdToken[tokenLength - 1] == '"');
-
-            // Detect if string is numeric, if not already string parsing
-            const int tokenNumericalType = !isStringParsing && !isStringStart && !isStringEnd ? isNumericStr(cmdToken, tokenLength) : 0;
-            commandToken.type = tokenNumericalType; // 0 for strings, 1 for int/uint, 2 for double/float
-
-            // Did a previous token start a string sequence?
-            // Or is this the start of a new string? Numbers can skip this step
-            if (tokenNumericalType) {
-              strcpy(commandToken.str, cmdToken);
-            } else {
-              if (isStringStart) {
-                isStringParsing = true;
-                strcpy(commandToken.str, &cmdToken[1]); // trim off first quotation
-                strcat(commandToken.str, whitespaceStr);
-              } else if (isStringEnd) {
-                isStringParsing = false;
-                strcat(commandToken.str, cmdToken);
-                commandToken.str[strlen(commandToken.str)-1] = 0; // pop off last quotation
-              } else if (isStringParsing) {
-                strcat(commandToken.str, cmdToken);
-                strcat(commandToken.str, whitespaceStr);
-              } else if (!isStringParsing) {
-                // not parsing a string, just copy token value
-                strcpy(commandToken.str, cmdToken);
-              }
-            }
-          }
-
-          // Push as an individual token if not parsing a string
-          if (!isStringParsing) {
-            commandResult.tokens.push_back(commandToken);
-          }
+          // 0 for strings, 1 for int/uint, 2 for double/float
+          commandToken.type = isNumericStr(cmdToken.data(), cmdToken.size());
         }
 
-        // Onto the next token
-        cmdToken = strtok(NULL, whitespaceStr);
+        commandToken.str = cmdToken.data();
+        commandToken.length = (uint16_t)cmdToken.size();
+        commandResult.tokens.push_back(commandToken);
+      }
+      if (tokenizer.next(cmdToken, isQuoted)) {
+        throw DeusConsoleException("Too many arguments");
+      }
 
-        // Dont go over allowed token count
-        if (commandResult.argc >= 16) {
-          break;
+      // Terminate slices now that the tokenizer is done reading the buffer
+      if (targetLength > 0) {
+        buffer[commandResult.target - buffer + targetLength] = 0;
+      }
+      for (DeusCommandToken& token : commandResult.tokens) {
+        const size_t offset = (uintptr_t)token.str - (uintptr_t)buffer;
+        if (offset < inputLength) {
+          buffer[offset + token.length] = 0;
         }
       }
 
-      // Make sure we're not somehow stuck parsing after loop
-      assert(isStringParsing == false);
       commandResult.argc = commandResult.tokens.size();
       return commandResult;
     }
 
     // This method will take a command string and run it, returning result as string
-    // the supplied command must be a single command only, line pre-processing would be done at another step
+    // commands can be chained with ';', their outputs are joined by newlines
     std::string runCommand(const char* command) {
       std::string result;
       this->runCommand(command, result);
@@ -397,11 +2675,342 @@ class IDeusConsoleManager {
     }
 
     // This method will take a command string and run it, putting returned string into the referenced output string
-    // the supplied command must be a single command only, line pre-processing would be done at another step
+    // commands can be chained with ';', an error in any of them throws and stops the rest from running
     void runCommand(const char* command, std::string& outputStr) {
       DeusCommandType commandResult;
-      this->runCommandAs<const char*>(command, commandResult);
-      outputStr = commandResult.returnStr;
+      DeusCommandSplitter splitter(command);
+      std::string_view statement;
+      outputStr.clear();
+      while (splitter.next(statement)) {
+        this->parseCommand(statement, commandResult);
+        if (this->deferRemainder(commandResult, splitter)) {
+          break;
+        }
+        this->runParsedCommand(commandResult);
+        if (!commandResult.returnStr.empty()) {
+          if (!outputStr.empty()) {
+            outputStr += '\n';
+          }
+          outputStr += commandResult.returnStr;
+        }
+      }
+    }
+
+    // Runs a command string like above, streaming output into a sink as each command writes it rather than
+    // returning it. Outputs of chained commands are separated by newlines. An error throws and stops the rest
+    // from running, output written before it has already been sent
+    void runCommand(const char* command, DeusOutputSink sink) {
+      bool hasOutput = false;
+      bool needsNewline = false;
+      auto separate = [&sink, &hasOutput, &needsNewline](std::string_view text) {
+        if (needsNewline) {
+          sink.write("\n");
+          needsNewline = false;
+        }
+        sink.write(text);
+        hasOutput = true;
+      };
+      const DeusOutputSink separatedSink(separate);
+
+      DeusCommandType commandResult;
+      commandResult.output = &separatedSink;
+      DeusCommandSplitter splitter(command);
+      std::string_view statement;
+      while (splitter.next(statement)) {
+        this->parseCommand(statement, commandResult);
+        if (this->deferRemainder(commandResult, splitter)) {
+          break;
+        }
+        this->runParsedCommand(commandResult);
+        if (!commandResult.returnStr.empty()) {
+          separatedSink.write(commandResult.returnStr);
+        }
+        needsNewline = needsNewline || hasOutput;
+        hasOutput = false;
+      }
+    }
+
+    // Starts a pool of worker threads that runs thread safe methods from batches in parallel, zero stops it.
+    // Call while no batches are running, usually once at startup
+    void setWorkerCount(size_t count) {
+      this->workerPool.reset(count > 0 ? new DeusWorkerPool(count) : NULL);
+    }
+
+    size_t getWorkerCount() const {
+      return this->workerPool ? this->workerPool->size() : 0;
+    }
+
+    // Runs every command in the input, separated by ';' or newlines, appending to a single result.
+    // Errors are recorded per command rather than thrown, unless stopOnError is set the rest still run.
+    // With a worker pool, consecutive calls to DEUS_METHOD_THREADSAFE methods run in parallel, their results
+    // are still recorded in order. Returns the number of commands that failed
+    size_t runBatch(std::string_view commands, DeusBatchResult& result, bool stopOnError = false) {
+      const auto startTime = std::chrono::steady_clock::now();
+      DeusCommandType commandResult;
+      DeusCommandSplitter splitter(commands);
+      std::string_view statement;
+      const size_t initialErrors = result.errorCount;
+      std::deque<DeusParallelCommand> parallelCommands;
+      std::atomic<size_t> parallelRemaining(0);
+      bool deferred = false;
+      bool stopped = false;
+      try {
+        while (!deferred && !stopped && splitter.next(statement)) {
+          DeusBatchEntry entry;
+          entry.line = splitter.line;
+          try {
+            this->parseCommand(statement, commandResult);
+            if (this->isParallelCommand(commandResult)) {
+              this->submitParallel(commandResult, entry.line, parallelCommands, parallelRemaining);
+              continue;
+            }
+
+            // Anything else waits for the parallel commands before it, so output stays in order
+            stopped = !this->finishParallel(parallelCommands, parallelRemaining, result, stopOnError);
+            if (stopped) {
+              break;
+            }
+            entry.outputOffset = result.output.size();
+            deferred = this->deferRemainder(commandResult, splitter);
+            if (!deferred) {
+              this->runParsedCommand(commandResult);
+              result.output += commandResult.returnStr;
+            }
+          } catch (const std::exception& e) { // Any failure is recorded against this statement and the rest still run
+            stopped = !this->finishParallel(parallelCommands, parallelRemaining, result, stopOnError);
+            if (stopped) {
+              break;
+            }
+            entry.outputOffset = result.output.size();
+            entry.success = false;
+            result.output += e.what();
+            result.errorCount++;
+          }
+          entry.outputLength = result.output.size() - entry.outputOffset;
+          result.entries.push_back(entry);
+          stopped = !entry.success && stopOnError;
+        }
+        this->finishParallel(parallelCommands, parallelRemaining, result, stopOnError);
+      } catch (...) {
+        // Parallel commands reference this frame, they have to finish before it unwinds
+        this->waitParallel(parallelRemaining);
+        throw;
+      }
+      result.elapsedMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+      return result.errorCount - initialErrors;
+    }
+
+    // Queues a command to be run by the next drainQueue call, safe to call from any thread.
+    // The callback is invoked on the draining thread with the output, or the error message if the
+    // command threw. Returns false if the queue is full, throws if the command is too long
+    bool enqueueCommand(std::string_view command, TDeusCommandCallback callback = NULL) {
+      return this->commandQueue.push(command, std::move(callback));
+    }
+
+    // Returns the number of commands waiting to be drained
+    size_t queuedCount() const {
+      return this->commandQueue.size();
+    }
+
+    // Runs queued commands in submission order on the calling thread, which should be the thread that owns
+    // the console. Stops after maxCommands, or once budgetMs has elapsed if it is above zero.
+    // Returns the number of commands that ran
+    size_t drainQueue(size_t maxCommands = SIZE_MAX, double budgetMs = 0.0) {
+      const auto startTime = std::chrono::steady_clock::now();
+      char command[DEUS_COMMAND_MAX_LENGTH];
+      TDeusCommandCallback callback;
+      std::string output;
+      size_t ranCount = 0;
+      while (ranCount < maxCommands && this->commandQueue.pop(command, callback)) {
+        bool success = true;
+        try {
+          this->runCommand(command, output);
+        } catch (const std::exception& e) { // Any failure is reported, the producer may be waiting on the callback
+          success = false;
+          output = e.what();
+        }
+        ranCount++;
+        if (callback) {
+          callback(success, output);
+        }
+
+        if (budgetMs > 0.0 && std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() >= budgetMs) {
+          break;
+        }
+      }
+      return ranCount;
+    }
+
+    // Schedules commands to run after a number of ticks, at least one. They run through runBatch
+    // so they can be chained or contain wait statements of their own. Safe to call from any thread
+    void scheduleCommand(std::string_view commands, uint32_t delayFrames = 1) {
+      std::lock_guard<std::mutex> lock(this->scheduleMutex);
+      this->pushScheduled(this->frameSchedule, this->currentFrame + std::max<uint32_t>(delayFrames, 1), commands);
+    }
+
+    // Schedules commands to run on the first tick after a delay in milliseconds has passed, see above
+    void scheduleCommandMs(std::string_view commands, double delayMs) {
+      if (!(delayMs >= 0.0)) {
+        throw DeusConsoleException("Schedule delay cannot be negative");
+      }
+
+      // Clamp before converting, huge delays such as waitms 1e300 would overflow the cast or the addition
+      const uint64_t now = steadyNowNs();
+      const uint64_t maxDelayNs = UINT64_MAX - now;
+      const double delayNs = delayMs * 1e6;
+      const uint64_t due = delayNs >= (double)maxDelayNs || (uint64_t)delayNs > maxDelayNs ? UINT64_MAX : now + (uint64_t)delayNs;
+      std::lock_guard<std::mutex> lock(this->scheduleMutex);
+      this->pushScheduled(this->timeSchedule, due, commands);
+    }
+
+    // Returns the number of scheduled commands that havent run yet
+    size_t scheduledCount() {
+      std::lock_guard<std::mutex> lock(this->scheduleMutex);
+      return this->frameSchedule.size() + this->timeSchedule.size();
+    }
+
+    // Returns the number of ticks so far
+    uint64_t getFrame() {
+      std::lock_guard<std::mutex> lock(this->scheduleMutex);
+      return this->currentFrame;
+    }
+
+    // Returns the number of long running methods that havent finished
+    size_t taskCount() {
+      std::lock_guard<std::mutex> lock(this->taskMutex);
+      return this->tasks.size();
+    }
+
+    // Resumes long running methods in turn until they finish or budgetMs has elapsed, at least one step
+    // always runs. Each step that produces output or throws adds an entry to result. Returns the number of steps
+    size_t runTasks(DeusBatchResult& result, double budgetMs = DEUS_TASK_BUDGET_MS) {
+      {
+        std::lock_guard<std::mutex> lock(this->taskMutex);
+        for (DeusRunningTask& task : this->tasks) {
+          this->steppingTasks.push_back(std::move(task));
+        }
+        this->tasks.clear();
+      }
+
+      const auto startTime = std::chrono::steady_clock::now();
+      std::string output;
+      size_t stepCount = 0;
+      size_t resumeFrom = 0;
+      bool running = !this->steppingTasks.empty();
+      while (running) {
+        running = false;
+        for (size_t i = 0; i < this->steppingTasks.size(); i++) {
+          DeusRunningTask& task = this->steppingTasks[i];
+          if (task.done) {
+            continue;
+          }
+
+          DeusBatchEntry entry;
+          entry.outputOffset = result.output.size();
+          output.clear();
+          try {
+            task.done = task.step(output);
+          } catch (const std::exception& e) { // Any failure ends the task, letting one escape would lose the stepping tasks
+            task.done = true;
+            entry.success = false;
+            output.assign(task.name).append(": ").append(e.what());
+            result.errorCount++;
+          }
+          if (!output.empty()) {
+            result.output += output;
+            entry.outputLength = output.size();
+            result.entries.push_back(entry);
+          }
+          stepCount++;
+          running = running || !task.done;
+
+          // Out of time, the next tick carries on from the following task
+          if (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() >= budgetMs) {
+            resumeFrom = i + 1;
+            running = false;
+            break;
+          }
+        }
+      }
+
+      // Put unfinished tasks back ahead of any started while stepping
+      std::lock_guard<std::mutex> lock(this->taskMutex);
+      const size_t steppedCount = this->steppingTasks.size();
+      for (DeusRunningTask& task : this->tasks) {
+        this->steppingTasks.push_back(std::move(task));
+      }
+      this->tasks.clear();
+      for (size_t i = 0; i < this->steppingTasks.size(); i++) {
+        DeusRunningTask& task = this->steppingTasks[i < steppedCount ? (resumeFrom + i) % steppedCount : i];
+        if (!task.done) {
+          this->tasks.push_back(std::move(task));
+        }
+      }
+      this->steppingTasks.clear();
+      return stepCount;
+    }
+
+    // Advances the scheduler by a frame and runs every command that is now due, then resumes long running
+    // methods for up to taskBudgetMs, call once per host frame. Output and errors are appended to result,
+    // a failing command never stops the others or the tasks. Returns the number of scheduled commands that ran
+    size_t tick(DeusBatchResult& result, double taskBudgetMs = DEUS_TASK_BUDGET_MS) {
+      std::unique_lock<std::mutex> lock(this->scheduleMutex);
+      const uint64_t frame = ++this->currentFrame;
+      const uint64_t now = steadyNowNs();
+      const uint64_t orderLimit = this->scheduleOrder;
+      DeusScheduledCommand scheduled;
+      size_t ranCount = 0;
+      while (popScheduled(this->frameSchedule, frame, orderLimit, scheduled) || popScheduled(this->timeSchedule, now, orderLimit, scheduled)) {
+        lock.unlock();
+        try {
+          this->runBatch(scheduled.commands, result);
+        } catch (const std::exception& e) { // Anything runBatch lets through fails this command only, the rest still run
+          DeusBatchEntry entry;
+          entry.outputOffset = result.output.size();
+          entry.success = false;
+          result.output += e.what();
+          entry.outputLength = result.output.size() - entry.outputOffset;
+          result.entries.push_back(entry);
+          result.errorCount++;
+        }
+        ranCount++;
+        lock.lock();
+      }
+      lock.unlock();
+
+      this->runTasks(result, taskBudgetMs);
+      return ranCount;
+    }
+
+    // Advances the scheduler discarding the output of commands that ran
+    size_t tick() {
+      DeusBatchResult result;
+      return this->tick(result);
+    }
+
+    // Runs a script file through runBatch, the file is memory mapped and split in place.
+    // Throws if the file cant be opened, otherwise returns the number of commands that failed
+    size_t execFile(const char* path, DeusBatchResult& result, bool stopOnError = false) {
+      // Track nesting per thread so scripts that exec themselves cant recurse forever
+      static thread_local size_t execDepth = 0;
+      if (execDepth >= 16) {
+        throw DeusConsoleException("Script files are nested too deeply: " + (std::string)path);
+      }
+      const auto startTime = std::chrono::steady_clock::now();
+      DeusMappedFile file(path);
+
+      const double initialElapsed = result.elapsedMs;
+      execDepth++;
+      size_t errors = 0;
+      try {
+        errors = this->runBatch(file.view(), result, stopOnError);
+      } catch (...) {
+        execDepth--;
+        throw;
+      }
+      execDepth--;
+      result.elapsedMs = initialElapsed + std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+      return errors;
     }
 
     // This method will take a command string and return its result typecasted to the supplied type
@@ -409,69 +3018,58 @@ class IDeusConsoleManager {
     template <typename T>
     T runCommandAs(const char* command, DeusCommandType& commandResult) {
       this->parseCommand(command, commandResult);
-      const char* cmdTarget = (const char*)commandResult.target;
-      const bool methodExists = this->methodExists(cmdTarget);
+      DeusConsoleVariable* variable = this->runParsedCommand(commandResult);
+      if (variable != NULL) {
+        return *static_cast<T*>(variable->value);
+      }
+      return static_cast<T>(NULL);
+    }
+
+    // Runs an already parsed command, returning the target variable if it was read or written
+    // or NULL if a method was called instead
+    DeusConsoleVariable* runParsedCommand(DeusCommandType& commandResult) {
+      const DeusCVarName cmdTarget((const char*)commandResult.target); // Hashed once for both tables
+      DeusConsoleMethod* method = this->findMethod(cmdTarget);
 
       // Check if target is a variable to write/read
-      if (this->variableExists(cmdTarget)) {
+      DeusConsoleVariable* foundVariable = this->findVariable(cmdTarget);
+      if (foundVariable != NULL) {
+        DeusConsoleVariable& variable = *foundVariable;
         if (commandResult.argc == 0) { // Zero tokens is a read op
-          // TODO: FIX: Reading variable doesnt add its value to returnStr
-          DeusConsoleVariable& variable = this->getVariable(cmdTarget);
-          commandResult.returnStr = variable.toString();
-          return this->getCVar<T>(cmdTarget);
+          variable.ops->toString(variable.value, commandResult.returnStr);
+          return &variable;
         } else if (commandResult.argc == 1) { // One token is write op
-          // Get the variable for our intended target
-          DeusConsoleVariable& variable = this->getVariable(cmdTarget);
-
           // Disallow writing to constants
           // TODO: disallow writing if production mode
           if (variable.flags & DEUS_CVAR_READONLY) {
             throw DeusConsoleException("Cannot write to a constant variable");
           }
 
-          // Gather input buffer and type
-          char* tokenInput = commandResult.tokens[0].str;
-          const int tokenType = commandResult.tokens[0].type;
-
-          // Write to variable depending on if string, integer or decimal
-          if (tokenType == DEUS_VARTYPE_STRING) { // Write string
-            std::string tokenStr(tokenInput);
-            variable.write(&tokenStr);
-          } else if (tokenType == DEUS_VARTYPE_INT || tokenType == DEUS_VARTYPE_DEC) {
-            if (tokenType == DEUS_VARTYPE_INT) { // Integer
-              variable.writeIntFromBuffer(tokenInput);
-            } else if (tokenType == DEUS_VARTYPE_DEC) { // Decimal number
-              variable.writeDecimalFromBuffer(tokenInput);
-            }
-          } else if (tokenType == DEUS_VARTYPE_BOOL_FALSE) {
-            variable.writeIntFromBuffer(tokenInput);
-          } else if (tokenType == DEUS_VARTYPE_BOOL_TRUE) {
-            variable.writeIntFromBuffer(tokenInput);
-          } else { // Should never happen
-            assert(false);
+          // Frame synced writes are published by commitFrame, which also fires the update hook
+          if (this->frameSync.load(std::memory_order_relaxed)) {
+            this->stageWrite(variable, commandResult.tokens[0]);
+            return &variable;
           }
 
-          // Fire on update hook
-          if (variable.onUpdate) {
-            variable.onUpdate(&variable);
-          }
+          // Arithmetic variables parse the token, strings take it as is
+          const DeusCommandToken& token = commandResult.tokens[0];
+          variable.ops->writeText(variable.value, std::string_view(token.str, token.length));
+          variable.fireUpdate();
 
-          // Return new value
-          return static_cast<T>(this->getCVar<T>(cmdTarget));
-        } else if (!methodExists) { // More than 1 token is a no-op on a variable
+          return &variable;
+        } else if (method == NULL) { // More than 1 token is a no-op on a variable
           throw DeusConsoleException("Too many arguments");
         }
       }
 
       // Check if a method exists, since variable read/write didnt pass
-      if (methodExists) {
-        TDeusConsoleFunc& method = this->getMethod(cmdTarget);
-        method(commandResult);
+      if (method != NULL) {
+        method->func(commandResult);
       } else {
-        throw DeusConsoleException("No variable or method found: " + (std::string)cmdTarget);
+        throw DeusConsoleException("No variable or method found: " + (std::string)cmdTarget.str);
       }
 
-      return static_cast<T>(NULL);
+      return NULL;
     }
 
     // This method will take a command string and return its result typecasted to the supplied type
@@ -499,7 +3097,7 @@ class TDeusStaticConsoleVariable {
     T rawValue;
 
   public:
-    TDeusStaticConsoleVariable(const char* name, T value, const char* description = "", int flags = DEUS_CVAR_DEFAULT, TDeusConsoleFuncVoid onUpdate = NULL) {
+    TDeusStaticConsoleVariable(DeusCVarName name, T value, const char* description = "", int flags = DEUS_CVAR_DEFAULT, TDeusConsoleFuncVoid onUpdate = NULL) {
       this->rawValue = value;
       IDeusConsoleManager::get()->registerCVar(name, this->rawValue, description, flags, onUpdate);
     }
@@ -513,4 +3111,30 @@ class TDeusStaticConsoleVariable {
     }
 };
 
+// Helper for statically declared console variables that are read from other threads, the value is
+// stored in a std::atomic so workers can read it without locks or torn values while the console writes it
+template<typename T>
+class TDeusAtomicConsoleVariable {
+  static_assert(std::is_arithmetic_v<T>, "Atomic console variables must wrap an arithmetic type");
+
+  private:
+    std::atomic<T> rawValue;
+
+  public:
+    TDeusAtomicConsoleVariable(DeusCVarName name, T value, const char* description = "", int flags = DEUS_CVAR_DEFAULT, TDeusConsoleFuncVoid onUpdate = NULL) {
+      this->rawValue.store(value, std::memory_order_relaxed);
+      IDeusConsoleManager::get()->registerCVar(name, this->rawValue, description, flags, onUpdate);
+    }
+
+    void set(T value, std::memory_order order = std::memory_order_release) {
+      this->rawValue.store(value, order);
+    }
+
+    // Reads with acquire ordering by default, pass std::memory_order_relaxed when the value
+    // doesnt guard other data for the cheapest possible read
+    T get(std::memory_order order = std::memory_order_acquire) const {
+      return this->rawValue.load(order);
+    }
+};
+
 #endif
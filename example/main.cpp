@@ -24,7 +24,7 @@ inline void setGUIStyles();
 
 // We will also declare some demo variables globally so we can keep this program procedural for simplification purposes
 // in your real implementation of deus console you will probably want to wrap into a class
-static std::vector<std::string> outputStream; // Output from the console engine
+static DeusOutputRing outputStream(4096, 256 * 1024); // Newest output from the console engine, in fixed memory
 static std::vector<std::string> commandHistory; // All user inputs
 static char commandBuffer[512]; // User input text
 static int historyPos = 0;
@@ -71,6 +71,11 @@ inline void bindBaseCommands() {
 
     cmd.returnStr = std::to_string(result);
   }, "Adds together a sequence of numbers");
+
+  // Typed methods have their arguments counted and converted for them
+  console->registerMethod("multiply", [](float a, float b) {
+    return a * b;
+  }, "Multiplies two numbers");
 }
 
 // Processes a command and outputs the result or error to "outputStream"
@@ -78,25 +83,14 @@ inline void processCommand(char* cmd) {
   IDeusConsoleManager* console = IDeusConsoleManager::get();
   std::string cmdStr = std::string(cmd);
   commandHistory.push_back(cmdStr);
-  outputStream.push_back((std::string)"> " + cmdStr);
+  outputStream.appendLine((std::string)"> " + cmdStr);
   try {
     std::string returnOutput = console->runCommand(cmd);
-    outputStream.push_back(returnOutput);
+    outputStream.append(returnOutput);
   } catch (DeusConsoleException e) {
     std::string errorOutput = (std::string)"ERROR: " + e.what();
-    outputStream.push_back(errorOutput);
-  }
-}
-
-// Compare strings by n
-inline static int compareStrs(const char *s1, const char *s2, int n) {
-  int d = 0;
-  while (n > 0 && (d = tolower(*s2) - tolower(*s1)) == 0 && *s1) {
-    s1++;
-    s2++;
-    n--;
+    outputStream.append(errorOutput);
   }
-  return d;
 }
 
 // Called when user requests text completion
@@ -105,21 +99,25 @@ inline void textCompletionCallback(ImGuiInputTextCallbackData* data) {
   const char* strEnd = data->Buf + data->CursorPos;
   const char* strStart = data->Buf;
 
-  // Read help table and compare strings with input to see if any match
-  std::string candidate;
-  DeusConsoleHelpTable& helpTable = console->getHelpTable();
-  for (auto it = helpTable.begin(); it != helpTable.end(); it++) {
-    if (compareStrs(it->first, strStart, (int)(strEnd - strStart)) == 0) {
-      candidate = std::string(it->first);
-      break;
-    }
+  // Find every name starting with the input, sorted, and the prefix they share
+  static std::vector<std::string_view> matches;
+  const std::string_view common = console->complete(std::string_view(strStart, strEnd - strStart), matches);
+  if (matches.empty()) {
+    return;
   }
 
-  // If candiate was found, insert it at current position
-  if (!candidate.empty()) {
-    data->DeleteChars((int)(strStart - data->Buf), (int)(strEnd - strStart));
-    data->InsertChars(data->CursorPos, candidate.c_str());
-    data->InsertChars(data->CursorPos, " ");
+  // Complete as far as the matches agree, a single match is finished with a space
+  const std::string candidate = matches.size() == 1 ? std::string(matches[0]) + " " : std::string(common);
+  data->DeleteChars((int)(strStart - data->Buf), (int)(strEnd - strStart));
+  data->InsertChars(data->CursorPos, candidate.c_str());
+
+  // List the options when there are several
+  if (matches.size() > 1) {
+    std::string options;
+    for (const std::string_view match : matches) {
+      options.append(match).append("  ");
+    }
+    outputStream.appendLine(options);
   }
 }
 
@@ -191,11 +189,9 @@ inline void renderInput() {
 
 // Renders output strings into imgui text and performs auto scrolling
 inline void renderOutput() {
-  const size_t lineCount = outputStream.size();
-  for (size_t i = 0; i < lineCount; i++) {
-    std::string& line = outputStream[i];
-    ImGui::Text(line.c_str());
-  }
+  outputStream.forEachLast(outputStream.size(), [](std::string_view line) {
+    ImGui::TextUnformatted(line.data(), line.data() + line.size());
+  });
 
   if (ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) {
     ImGui::SetScrollHereY(1.0f);
@@ -229,6 +225,15 @@ static void main_loop(void* arg) {
     ImGui_ImplSDL2_ProcessEvent(&event);
   }
 
+  // Run scheduled commands and resume long running methods, streaming their output
+  static DeusBatchResult tickResult;
+  tickResult.clear();
+  console->tick(tickResult);
+  for (size_t i = 0; i < tickResult.entries.size(); i++) {
+    const std::string_view tickOutput = tickResult.getOutput(i);
+    outputStream.append(tickResult.entries[i].success ? std::string(tickOutput) : "ERROR: " + std::string(tickOutput));
+  }
+
   // Start the Dear ImGui frame
   ImGui_ImplOpenGL3_NewFrame();
   ImGui_ImplSDL2_NewFrame();
@@ -1,9 +1,28 @@
 #include "deus-console.h"
 #include <iostream>
+#include <atomic>
+#include <thread>
+
+// Count heap allocations so tests can assert that hot paths dont allocate
+static std::atomic<size_t> heapAllocCount(0);
+void* operator new(size_t size) {
+  heapAllocCount++;
+  void* ptr = malloc(size);
+  if (ptr == NULL) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+void operator delete(void* ptr) noexcept {
+  free(ptr);
+}
+void operator delete(void* ptr, size_t) noexcept {
+  free(ptr);
+}
 
 // Test console variables
 static TDeusStaticConsoleVariable<const char*> CVarTestCString(
-  "test.cstring",
+  DEUS_CVAR("test.cstring"),
   "mystr",
   "A test C string variable",
   // This should be immutable, as its a const char, it can only change to other const chars otherwise memory issues will occur
@@ -12,32 +31,32 @@ static TDeusStaticConsoleVariable<const char*> CVarTestCString(
 );
 
 static TDeusStaticConsoleVariable<std::string> CVarTestString(
-  "test.string",
+  DEUS_CVAR("test.string"),
   (std::string)"cppstring",
   "A test string variable"
 );
 
 static TDeusStaticConsoleVariable<float> CVarTestFloat(
-  "test.float",
+  DEUS_CVAR("test.float"),
   3.142f,
   "A test float variable"
 );
 
 static TDeusStaticConsoleVariable<uint8_t> CVarTestUint(
-  "test.uint",
+  DEUS_CVAR("test.uint"),
   200,
   "A test uint8_t variable"
 );
 
 static TDeusStaticConsoleVariable<bool> CVarTestBool(
-  "test.bool",
+  DEUS_CVAR("test.bool"),
   true,
   "A test bool variable"
 );
 
 static bool didIntChange = false;
 static TDeusStaticConsoleVariable<int> CVarTestInteger(
-  "test.integer",
+  DEUS_CVAR("test.integer"),
   123,
   "A test integer variable",
   DEUS_CVAR_DEFAULT,
@@ -46,6 +65,16 @@ static TDeusStaticConsoleVariable<int> CVarTestInteger(
   }
 );
 
+static TDeusAtomicConsoleVariable<int> CVarTestAtomic(
+  DEUS_CVAR("test.atomic"),
+  0,
+  "A test atomic integer variable read from other threads"
+);
+
+// Static names within this file must not collide
+DEUS_CVAR_ASSERT_UNIQUE("test.cstring", "test.string", "test.float", "test.uint", "test.bool", "test.integer", "test.atomic");
+static_assert(DEUS_CVAR("test.integer").hash == deusHashName("test.integer", 12), "Literal names are hashed at compile time");
+
 // Test helpers
 #define expectEqual(what, value, msg) std::cout << msg << ": "; if (what == value) { std::cout << "SUCCESS" << std::endl; } else { std::cout << "FAILED" << std::endl << "Got: " << what << std::endl << "Expected: " << value << std::endl; exit(1); }
 
@@ -87,6 +116,7 @@ int main(int argc, char* argv[]) {
   expectEqual(console->getCVar<const char*>("test.cstring"), "hello world", "Reading c string from console with getCVar");
   expectEqual(console->getCVar<std::string>("test.string"), "hello cpp", "Reading string from console with getCVar");
   expectEqual(console->getCVar<float>("test.float"), 3.142f, "Reading float from console with getCVar");
+  expectEqual(console->getCVar<float>(DEUS_CVAR("test.float")), 3.142f, "Reading float from console with a compile time hashed name");
 
   // Test reading statically assigned variables with command strings
   // expectEqual(console->runCommand("test.string"), "hello cpp", "Reading string from with runCommand");
@@ -141,7 +171,50 @@ int main(int argc, char* argv[]) {
   console->runCommand("test.float 4.21");
   expectEqual(console->getCVar<float>("test.float"), 4.21f, "Changing float from console command");
 
+  // Numbers are formatted with the shortest representation that round trips
+  expectEqual(console->runCommand("test.float"), "4.21", "Reading float from console command is not padded");
+
+  // Values that dont fit a variable are rejected instead of wrapping
+  didThrow = false;
+  try {
+    console->runCommand("test.uint 300");
+  } catch (const DeusConsoleException&) {
+    didThrow = true;
+  }
+  expectEqual(didThrow, true, "Writing an out of range value throws exception");
+  expectEqual(console->getCVar<uint8_t>("test.uint"), 1, "Writing an out of range value leaves variable unchanged");
+
+  didThrow = false;
+  try {
+    console->runCommand("test.integer notanumber");
+  } catch (const DeusConsoleException&) {
+    didThrow = true;
+  }
+  expectEqual(didThrow, true, "Writing text to a numeric variable throws exception");
+
+  console->runCommand("test.integer -42");
+  expectEqual(console->getCVar<int>("test.integer"), -42, "Changing integer to a negative number from console command");
+  console->runCommand("test.integer +5");
+  expectEqual(console->getCVar<int>("test.integer"), 5, "Changing integer with a leading plus sign");
+  console->runCommand("test.float +2.5");
+  expectEqual(console->getCVar<float>("test.float"), 2.5f, "Changing float with a leading plus sign");
+  size_t nonFiniteRejected = 0;
+  const char* nonFiniteCommands[] = { "test.float nan", "test.float inf", "test.float -inf", "test.float 1e999", "test.integer +-5" };
+  for (const char* nonFiniteCommand : nonFiniteCommands) {
+    try {
+      console->runCommand(nonFiniteCommand);
+    } catch (const DeusConsoleException&) {
+      nonFiniteRejected++;
+    }
+  }
+  const bool nonFiniteUnchanged = nonFiniteRejected == 5 && console->getCVar<float>("test.float") == 2.5f && console->getCVar<int>("test.integer") == 5;
+  expectEqual(nonFiniteUnchanged, true, "Writing nan, inf or a doubled sign throws and leaves variables unchanged");
+  console->runCommand("test.float 4.21; test.integer -42");
+
   // Changing strings with console commands
+  console->runCommand("test.string 123");
+  expectEqual(console->getCVar<std::string>("test.string"), "123", "Changing string to a number from console command");
+
   console->runCommand("test.string consoleiscool");
   expectEqual(console->getCVar<std::string>("test.string"), "consoleiscool", "Changing string to single word from console command");
 
@@ -160,14 +233,698 @@ int main(int argc, char* argv[]) {
   console->runCommand("test.runtimefloat 64.0");
   expectEqual(myRuntimeVar, 64.0f, "Modfying runtime float from command");
 
+  // Test resolving typed handles to variables
+  TDeusCVarRef<float> runtimeFloatRef = console->findCVar<float>("test.runtimefloat");
+  expectEqual(runtimeFloatRef.get(), 64.0f, "Reading runtime float from a resolved handle");
+
+  // Handles stay valid when other variables are registered
+  IDeusConsoleManager handleConsole;
+  float handleTestFloat = 1.0f;
+  static int handleTestValues[256];
+  static char handleTestNames[256][32];
+  handleConsole.registerCVar("handle.float", handleTestFloat);
+  TDeusCVarRef<float> handleFloatRef = handleConsole.findCVar<float>("handle.float");
+  for (int i = 0; i < 256; i++) {
+    snprintf(handleTestNames[i], sizeof(handleTestNames[i]), "handle.int%d", i);
+    handleConsole.registerCVar(handleTestNames[i], handleTestValues[i]);
+  }
+  handleConsole.runCommand("handle.float 32.5");
+  expectEqual(*handleFloatRef, 32.5f, "Resolved handle sees writes after other variables are registered");
+
+  // Registering from one thread while others run commands is safe, lookups dont take locks
+  IDeusConsoleManager stressConsole;
+  static int stressValues[2000];
+  static char stressNames[2000][32];
+  int stressBase = 7;
+  stressConsole.registerCVar("stress.base", stressBase, "", DEUS_CVAR_READONLY);
+  std::atomic<int> stressRegistered(0);
+  std::atomic<int> stressFailures(0);
+  std::thread stressWriter([&]() {
+    for (int i = 0; i < 2000; i++) {
+      snprintf(stressNames[i], sizeof(stressNames[i]), "stress.var%d", i);
+      stressConsole.registerCVar(stressNames[i], stressValues[i], "Stress test variable", DEUS_CVAR_READONLY);
+      stressRegistered.store(i + 1, std::memory_order_release);
+    }
+  });
+  auto stressReader = [&]() {
+    std::string output;
+    int registered = 0;
+    while (registered < 2000) {
+      registered = stressRegistered.load(std::memory_order_acquire);
+      stressConsole.runCommand("stress.base", output);
+      if (output != "7") {
+        stressFailures++;
+      }
+      if (registered > 0 && !stressConsole.variableExists(stressNames[registered - 1])) {
+        stressFailures++;
+      }
+      size_t helpCount = 0;
+      stressConsole.forEachHelp([&helpCount](std::string_view, const char*) {
+        helpCount++;
+      });
+      if (helpCount < (size_t)registered + 1) {
+        stressFailures++;
+      }
+    }
+  };
+  std::thread stressReaderA(stressReader);
+  std::thread stressReaderB(stressReader);
+  stressWriter.join();
+  stressReaderA.join();
+  stressReaderB.join();
+  expectEqual(stressFailures.load(), 0, "Registering variables while other threads run commands");
+
+  // Atomic variables can be read from worker threads while the console writes them
+  std::atomic<bool> atomicWritesDone(false);
+  std::atomic<int> atomicFailures(0);
+  auto atomicReader = [&]() {
+    int lastValue = 0;
+    while (!atomicWritesDone.load(std::memory_order_acquire)) {
+      const int value = CVarTestAtomic.get();
+      if (value < lastValue || value > 1000) {
+        atomicFailures++;
+      }
+      lastValue = value;
+    }
+  };
+  std::thread atomicReaderA(atomicReader);
+  std::thread atomicReaderB(atomicReader);
+  char atomicCommand[64];
+  for (int i = 1; i <= 1000; i++) {
+    snprintf(atomicCommand, sizeof(atomicCommand), "test.atomic %d", i);
+    console->runCommand(atomicCommand);
+  }
+  atomicWritesDone.store(true, std::memory_order_release);
+  atomicReaderA.join();
+  atomicReaderB.join();
+  expectEqual(atomicFailures.load(), 0, "Reading atomic variable from worker threads while writing");
+  expectEqual(console->runCommand("test.atomic"), "1000", "Reading atomic variable from console command");
+  expectEqual(console->getCVar<std::atomic<int>>("test.atomic").load(), 1000, "Reading atomic variable with getCVar");
+
+  // Handles are type checked when resolved
+  didThrow = false;
+  try {
+    console->findCVar<int>("test.runtimefloat");
+  } catch (const DeusConsoleException&) {
+    didThrow = true;
+  }
+  expectEqual(didThrow, true, "Resolving a handle with the wrong type throws exception");
+
   // Test trimming whitespace
   console->runCommand("test.integer 54321        \t");
   expectEqual(console->getCVar<int>("test.integer"), 54321, "End whitespace should be trimmed for a command");
 
-  // // Test command chaining
-  // console->runCommand("test.integer 42; test.string 'hello world'; myMethod");
-  // expectEqual(console->getCVar<int>("test.integer"), 42, "Command chaining operation 1 succeeds");
-  // expectEqual(console->getCVar<std::string>("test.string"), "hello world", "Command chaining operation 2 succeeds");
+  // Quoted strings keep their inner whitespace as is
+  console->runCommand("test.string 'two  spaces\tand tab'");
+  expectEqual(console->getCVar<std::string>("test.string"), "two  spaces\tand tab", "Quoted strings keep inner whitespace");
+  console->runCommand("test.string \"another test str\"");
+
+  // Test unterminated strings are rejected
+  didThrow = false;
+  try {
+    console->runCommand("test.string 'never closed");
+  } catch (const DeusConsoleException&) {
+    didThrow = true;
+  }
+  expectEqual(didThrow, true, "Unterminated string input throws exception");
+
+  // Tokenizers share no state, so separate threads can parse at the same time
+  std::atomic<int> tokenizeFailures(0);
+  auto tokenizeWorker = [&tokenizeFailures](const char* input, size_t expectedTokens) {
+    for (int i = 0; i < 10000; i++) {
+      DeusCommandTokenizer tokenizer(input);
+      std::string_view token;
+      bool isQuoted = false;
+      size_t tokenCount = 0;
+      while (tokenizer.next(token, isQuoted)) {
+        tokenCount++;
+      }
+      if (tokenCount != expectedTokens) {
+        tokenizeFailures++;
+      }
+    }
+  };
+  std::thread tokenizeThreadA(tokenizeWorker, "add 1 2 3 4 5 6 7", (size_t)8);
+  std::thread tokenizeThreadB(tokenizeWorker, "test.string 'a b c'", (size_t)2);
+  tokenizeThreadA.join();
+  tokenizeThreadB.join();
+  expectEqual(tokenizeFailures.load(), 0, "Tokenizing from two threads at once");
+
+  // Parsing keeps tokens inline, so even a full command doesnt allocate
+  DeusCommandType parsedCommand;
+  const size_t allocsBeforeParse = heapAllocCount;
+  console->parseCommand("add 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16", parsedCommand);
+  expectEqual(heapAllocCount - allocsBeforeParse, (size_t)0, "Parsing a command doesnt allocate");
+  expectEqual(parsedCommand.argc, DEUS_COMMAND_MAX_TOKENS, "Parsing keeps every argument up to the maximum");
+  std::string tooManyError;
+  try {
+    DeusCommandType tooManyCommand;
+    console->parseCommand("add 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17", tooManyCommand);
+  } catch (DeusConsoleException& e) {
+    tooManyError = e.what();
+  }
+  expectEqual(tooManyError, "Too many arguments", "Parsing more than the maximum arguments throws");
+
+  // Copied commands point at their own buffer
+  DeusCommandType copiedCommand = parsedCommand;
+  parsedCommand.buffer[0] = 0;
+  expectEqual((std::string)copiedCommand.target, "add", "Copied command keeps its target");
+  expectEqual(copiedCommand.tokens[15].toInt(), 16, "Copied command keeps its tokens");
+
+  // Test command chaining
+  std::string chainOutput = console->runCommand("test.integer 42; test.string 'hello; world'; myMethod");
+  expectEqual(console->getCVar<int>("test.integer"), 42, "Command chaining operation 1 succeeds");
+  expectEqual(console->getCVar<std::string>("test.string"), "hello; world", "Command chaining operation 2 succeeds");
+  expectEqual(chainOutput, "returned", "Command chaining returns outputs of commands");
+
+  // Test running a batch of commands, errors dont stop the batch
+  DeusBatchResult batchResult;
+  size_t batchErrors = console->runBatch("test.integer 7\ntest.doesnt.exist 1;test.integer;  ;\n", batchResult);
+  expectEqual(batchErrors, (size_t)1, "Batch reports failed commands");
+  expectEqual(batchResult.entries.size(), (size_t)3, "Batch runs every command");
+  expectEqual(batchResult.entries[1].success, false, "Batch records failure of a single command");
+  expectEqual(batchResult.getOutput(2), "7", "Batch records output of each command");
+
+  // Exceptions other than console errors fail only their own statement
+  IDeusConsoleManager throwingConsole;
+  int throwingValue = 0;
+  throwingConsole.registerCVar("throwing.value", throwingValue);
+  throwingConsole.registerMethod("throwing.method", [](DeusCommandType&) {
+    throw std::runtime_error("runtime failure");
+  });
+  DeusBatchResult throwingResult;
+  const size_t throwingErrors = throwingConsole.runBatch("throwing.value 1\nthrowing.method\nthrowing.value 2", throwingResult);
+  const bool throwingContained = throwingErrors == 1 && throwingResult.entries.size() == 3 && !throwingResult.entries[1].success &&
+    throwingResult.getOutput(1) == "runtime failure" && throwingValue == 2;
+  expectEqual(throwingContained, true, "Batch records other exceptions as failed commands and keeps running");
+
+  // Restore values that later tests expect
+  console->runCommand("test.integer 54321; test.string \"another test str\"");
+
+  // Test saving and restoring writable variables with a binary snapshot
+  std::vector<uint8_t> snapshot;
+  console->saveSnapshot(snapshot);
+  console->runCommand("test.integer 1; test.string changed; test.float 9.5");
+  didIntChange = false;
+  const size_t restoredCount = console->restoreSnapshot(snapshot);
+  expectEqual(console->getCVar<int>("test.integer"), 54321, "Restoring snapshot restores integer");
+  expectEqual(console->getCVar<std::string>("test.string"), "another test str", "Restoring snapshot restores string");
+  expectEqual(console->getCVar<float>("test.float"), 4.21f, "Restoring snapshot restores float");
+  expectEqual(didIntChange, true, "Restoring snapshot fires update hook of changed variables");
+  expectEqual((std::string)console->getCVar<const char*>("test.cstring"), "hello world", "Snapshot skips readonly variables");
+  expectEqual(restoredCount, (size_t)7, "Restoring snapshot returns restored count");
+
+  // A record whose name doesnt match its variable is skipped even though the hash does
+  std::vector<uint8_t> mismatchedSnapshot = snapshot;
+  const std::string integerName = "test.integer";
+  auto integerRecord = std::search(mismatchedSnapshot.begin(), mismatchedSnapshot.end(), integerName.begin(), integerName.end());
+  integerRecord[integerName.size() - 1] = 'R';
+  console->runCommand("test.integer 1");
+  const size_t mismatchedCount = console->restoreSnapshot(mismatchedSnapshot);
+  const bool mismatchedSkipped = mismatchedCount == 6 && console->getCVar<int>("test.integer") == 1;
+  expectEqual(mismatchedSkipped, true, "Restoring snapshot skips records whose name doesnt match");
+  console->runCommand("test.integer 54321");
+
+  // Test exporting writable variables as text commands
+  std::string exportedText;
+  console->exportText(exportedText);
+  const bool exportedInteger = exportedText.find("test.integer 54321\n") != std::string::npos;
+  const bool exportedString = exportedText.find("test.string 'another test str'\n") != std::string::npos;
+  const bool exportedReadonly = exportedText.find("test.cstring") != std::string::npos;
+  expectEqual(exportedInteger, true, "Text export contains integer variable");
+  expectEqual(exportedString, true, "Text export contains quoted string variable");
+  expectEqual(exportedReadonly, false, "Text export skips readonly variables");
+
+  // Exported text runs back into the same values, strings that cant be written as commands are left out
+  IDeusConsoleManager exportConsole;
+  std::string exportBothQuotes = "a\" b'c";
+  std::string exportSingleQuote = "a' b\"c";
+  std::string exportUnquotable = "x' y\" z";
+  std::string exportNewline = "line1\nline2";
+  int exportInt = -7;
+  exportConsole.registerCVar("export.both", exportBothQuotes);
+  exportConsole.registerCVar("export.single", exportSingleQuote);
+  exportConsole.registerCVar("export.unquotable", exportUnquotable);
+  exportConsole.registerCVar("export.newline", exportNewline);
+  exportConsole.registerCVar("export.int", exportInt);
+  std::string exportScript;
+  exportConsole.exportText(exportScript);
+  exportConsole.runCommand("export.both x; export.single x; export.unquotable x; export.newline x; export.int 0");
+  DeusBatchResult exportResult;
+  const size_t exportErrors = exportConsole.runBatch(exportScript, exportResult);
+  const bool exportRoundTrip = exportErrors == 0 && exportBothQuotes == "a\" b'c" && exportSingleQuote == "a' b\"c" && exportInt == -7;
+  expectEqual(exportRoundTrip, true, "Text export runs back into the same values");
+  const bool exportSkipped = exportUnquotable == "x" && exportNewline == "x" &&
+    exportScript.find("// export.unquotable skipped") != std::string::npos && exportScript.find("// export.newline skipped") != std::string::npos;
+  expectEqual(exportSkipped, true, "Text export leaves out values that cant be written as commands");
+
+  // Test frame synced writes are only published by commitFrame
+  IDeusConsoleManager frameConsole;
+  int frameInt = 1;
+  float frameFloat = 1.5f;
+  std::string frameString = "start";
+  int frameUpdates = 0;
+  frameConsole.registerCVar("frame.int", frameInt, "", DEUS_CVAR_DEFAULT, [&frameUpdates](void*) {
+    frameUpdates++;
+  });
+  frameConsole.registerCVar("frame.float", frameFloat);
+  frameConsole.registerCVar("frame.string", frameString);
+  frameConsole.setFrameSync(true);
+  frameConsole.runCommand("frame.int 2; frame.int 3; frame.float 2.5; frame.string next");
+  expectEqual(frameInt, 1, "Frame synced write is not applied before commit");
+  expectEqual(frameConsole.runCommand("frame.string"), "start", "Frame synced read returns published value");
+  expectEqual(frameConsole.pendingCount(), (size_t)3, "Frame synced writes to the same variable are merged");
+  expectEqual(frameConsole.commitFrame(), (size_t)3, "Committing a frame returns changed count");
+  expectEqual(frameInt, 3, "Committing a frame publishes the latest write");
+  expectEqual(frameFloat, 2.5f, "Committing a frame publishes float write");
+  expectEqual(frameString, "next", "Committing a frame publishes string write");
+  expectEqual(frameUpdates, 1, "Committing a frame fires update hook once");
+  didThrow = false;
+  try {
+    frameConsole.runCommand("frame.int abc");
+  } catch (const DeusConsoleException&) {
+    didThrow = true;
+  }
+  expectEqual(didThrow, true, "Frame synced write of invalid value throws exception");
+  frameConsole.runCommand("frame.int 3");
+  expectEqual(frameConsole.commitFrame(), (size_t)0, "Committing an unchanged value doesnt count as changed");
+  expectEqual(frameUpdates, 1, "Committing an unchanged value doesnt fire update hook");
+  std::vector<uint8_t> frameSnapshot;
+  frameConsole.saveSnapshot(frameSnapshot);
+  frameConsole.runCommand("frame.int 7; frame.string later");
+  frameConsole.commitFrame();
+  const size_t frameRestored = frameConsole.restoreSnapshot(frameSnapshot);
+  expectEqual(frameRestored, (size_t)3, "Frame synced restore counts staged variables");
+  expectEqual(frameInt, 7, "Frame synced restore is not applied before commit");
+  expectEqual(frameString, "later", "Frame synced restore of string is not applied before commit");
+  expectEqual(frameUpdates, 2, "Frame synced restore doesnt fire update hook before commit");
+  expectEqual(frameConsole.commitFrame(), (size_t)2, "Committing a frame publishes restored values");
+  expectEqual(frameInt, 3, "Committing a frame publishes restored int");
+  expectEqual(frameString, "next", "Committing a frame publishes restored string");
+  expectEqual(frameUpdates, 3, "Committing a restored value fires update hook");
+  frameConsole.runCommand("frame.int 4");
+  frameConsole.setFrameSync(false);
+  expectEqual(frameInt, 4, "Disabling frame sync publishes pending writes");
+  frameConsole.runCommand("frame.int 5");
+  expectEqual(frameInt, 5, "Writes apply immediately once frame sync is disabled");
+
+  // Test commands queued from other threads run on the draining thread
+  IDeusConsoleManager queueConsole;
+  int queueTotal = 0;
+  queueConsole.registerCVar("queue.total", queueTotal);
+  queueConsole.registerMethod("queue.add", [&queueTotal](DeusCommandType& cmd) {
+    queueTotal += atoi(cmd.tokens[0].str);
+  });
+  auto queueProducer = [&]() {
+    for (int i = 0; i < 200; i++) {
+      while (!queueConsole.enqueueCommand("queue.add 1")) {
+        std::this_thread::yield();
+      }
+    }
+  };
+  std::thread queueProducerA(queueProducer);
+  std::thread queueProducerB(queueProducer);
+  std::thread queueProducerC(queueProducer);
+  size_t queueDrained = 0;
+  while (queueDrained < 600) {
+    queueDrained += queueConsole.drainQueue(16);
+  }
+  queueProducerA.join();
+  queueProducerB.join();
+  queueProducerC.join();
+  expectEqual(queueTotal, 600, "Draining runs commands queued from several threads");
+  expectEqual(queueConsole.queuedCount(), (size_t)0, "Draining empties the queue");
+  std::string queueOutput;
+  bool queueSuccess = true;
+  queueConsole.enqueueCommand("queue.total", [&](bool success, const std::string& output) {
+    queueSuccess = success;
+    queueOutput = output;
+  });
+  queueConsole.enqueueCommand("queue.missing", [&](bool success, const std::string&) {
+    queueSuccess = queueSuccess && !success;
+  });
+  expectEqual(queueConsole.drainQueue(1), (size_t)1, "Draining stops at the command limit");
+  expectEqual(queueOutput, "600", "Queued command callback receives output");
+  queueConsole.drainQueue();
+  expectEqual(queueSuccess, true, "Queued command callback receives failure");
+  queueConsole.registerMethod("queue.fail", [](DeusCommandType&) {
+    throw std::runtime_error("not a console error");
+  });
+  std::string queueFailure;
+  queueConsole.enqueueCommand("queue.fail", [&queueFailure](bool success, const std::string& output) {
+    queueFailure = success ? "" : output;
+  });
+  queueConsole.drainQueue();
+  expectEqual(queueFailure, "not a console error", "Queued command callback receives failures other than console errors");
+  size_t queueAccepted = 0;
+  for (size_t i = 0; i < DEUS_COMMAND_QUEUE_CAPACITY + 8; i++) {
+    queueAccepted += queueConsole.enqueueCommand("queue.add 1") ? 1 : 0;
+  }
+  expectEqual(queueAccepted, DEUS_COMMAND_QUEUE_CAPACITY, "Queue rejects commands once full");
+  queueConsole.drainQueue();
+
+  // Test scheduled commands and wait statements run on later ticks
+  IDeusConsoleManager scheduleConsole;
+  int scheduleValue = 0;
+  scheduleConsole.registerCVar("schedule.value", scheduleValue);
+  scheduleConsole.scheduleCommand("schedule.value 2", 2);
+  scheduleConsole.scheduleCommandMs("schedule.value 100", 0.0);
+  expectEqual(scheduleConsole.scheduledCount(), (size_t)2, "Scheduled commands wait for a tick");
+  expectEqual(scheduleConsole.tick(), (size_t)1, "Tick runs commands that are due");
+  expectEqual(scheduleValue, 100, "Command scheduled by time runs on the next tick");
+  scheduleConsole.tick();
+  expectEqual(scheduleValue, 2, "Command scheduled by frames runs after its delay");
+  scheduleConsole.runCommand("schedule.value 3; wait; schedule.value 4; wait 2; schedule.value 5");
+  expectEqual(scheduleValue, 3, "Statements before wait run immediately");
+  scheduleConsole.tick();
+  expectEqual(scheduleValue, 4, "Statements after wait run on the next tick");
+  scheduleConsole.tick();
+  expectEqual(scheduleValue, 4, "Nested wait defers the rest again");
+  DeusBatchResult scheduleResult;
+  scheduleConsole.tick(scheduleResult);
+  expectEqual(scheduleValue, 5, "Nested wait runs the rest after its delay");
+  scheduleConsole.runBatch("schedule.value 6\nwaitms 0\nschedule.value 7\nschedule.missing", scheduleResult);
+  expectEqual(scheduleValue, 6, "Batch defers the rest of the script at waitms");
+  scheduleResult.clear();
+  scheduleConsole.tick(scheduleResult);
+  expectEqual(scheduleValue, 7, "Deferred batch runs on the next tick");
+  expectEqual(scheduleResult.errorCount, (size_t)1, "Deferred batch records errors in the tick result");
+  expectEqual(scheduleConsole.scheduledCount(), (size_t)0, "Ticking runs every due command");
+  expectEqual(scheduleConsole.getFrame(), (uint64_t)6, "Each tick advances the frame");
+  IDeusConsoleManager farConsole;
+  farConsole.registerCVar("schedule.value", scheduleValue);
+  farConsole.runCommand("waitms 1e300; schedule.value 8");
+  farConsole.tick();
+  const bool farPending = farConsole.scheduledCount() == 1 && scheduleValue == 7;
+  expectEqual(farPending, true, "Huge waitms delays are clamped and stay pending");
+
+  // Test long running methods are resumed by tick and stream their output
+  scheduleConsole.registerTask("schedule.count", [](DeusCommandType& cmd) -> TDeusTaskStep {
+    const int countTo = atoi(cmd.tokens[0].str);
+    return [countTo, current = 0](std::string& output) mutable {
+      output = std::to_string(++current);
+      if (current == 3) {
+        throw DeusConsoleException("three");
+      }
+      return current >= countTo;
+    };
+  }, "Counts up by one each step");
+  scheduleConsole.runCommand("schedule.count 2");
+  expectEqual(scheduleConsole.taskCount(), (size_t)1, "Running a task method starts a task");
+  scheduleResult.clear();
+  scheduleConsole.tick(scheduleResult, 0.0);
+  expectEqual(scheduleResult.output, "1", "Tick resumes a task for one step when out of budget");
+  scheduleConsole.tick(scheduleResult, 0.0);
+  expectEqual(scheduleResult.getOutput(1), "2", "Task output is streamed per step");
+  expectEqual(scheduleConsole.taskCount(), (size_t)0, "Finished tasks are removed");
+  scheduleConsole.runCommand("schedule.count 2; schedule.count 5");
+  scheduleResult.clear();
+  scheduleConsole.tick(scheduleResult, 0.0);
+  scheduleConsole.tick(scheduleResult, 0.0);
+  expectEqual(scheduleResult.output, "11", "Tasks take turns when out of budget");
+  scheduleResult.clear();
+  scheduleConsole.tick(scheduleResult, 1000.0);
+  expectEqual(scheduleResult.output, "22schedule.count: three", "Tasks run until finished within budget");
+  expectEqual(scheduleResult.errorCount, (size_t)1, "Task errors are recorded in the tick result");
+  expectEqual(scheduleConsole.taskCount(), (size_t)0, "Failed tasks are removed");
+  scheduleConsole.registerTask("schedule.crash", [](DeusCommandType&) -> TDeusTaskStep {
+    return [](std::string&) -> bool {
+      throw std::runtime_error("crashed");
+    };
+  });
+  scheduleConsole.runCommand("schedule.crash; schedule.count 2");
+  scheduleResult.clear();
+  scheduleConsole.tick(scheduleResult, 1000.0);
+  const bool crashRecorded = scheduleResult.output == "schedule.crash: crashed12" && scheduleConsole.taskCount() == 0;
+  expectEqual(crashRecorded, true, "Tasks throwing other exceptions fail without losing the other tasks");
+  scheduleConsole.registerMethod("schedule.throw", [](DeusCommandType&) {
+    throw std::runtime_error("thrown");
+  });
+  scheduleConsole.registerMethod("schedule.step", [](DeusCommandType& cmd) {
+    cmd.returnStr = "step";
+  });
+  scheduleConsole.runCommand("schedule.count 1; wait; schedule.throw; schedule.step");
+  scheduleConsole.scheduleCommand("schedule.step");
+  scheduleResult.clear();
+  const size_t throwRan = scheduleConsole.tick(scheduleResult, 1000.0);
+  const bool throwContained = throwRan == 2 && scheduleResult.output == "thrownstepstep1" && scheduleResult.errorCount == 1;
+  expectEqual(throwContained, true, "Throwing scheduled command doesnt stop other scheduled commands or tasks");
+
+  // Test thread safe methods run in parallel on the worker pool with results kept in order
+  IDeusConsoleManager poolConsole;
+  std::atomic<int> poolWorkCount(0);
+  poolConsole.setWorkerCount(3);
+  poolConsole.registerMethod("pool.work", [&poolWorkCount](DeusCommandType& cmd) {
+    if (cmd.tokens[0].toInt() < 0) {
+      throw DeusConsoleException("negative");
+    }
+    poolWorkCount++;
+    cmd.returnStr = cmd.tokens[0].str;
+  }, "Thread safe test method", DEUS_METHOD_THREADSAFE);
+  poolConsole.registerMethod("pool.count", [&poolWorkCount](DeusCommandType& cmd) {
+    cmd.returnStr = std::to_string(poolWorkCount.load());
+  });
+  std::string poolScript;
+  for (int i = 0; i < 100; i++) {
+    poolScript += "pool.work " + std::to_string(i) + "\n";
+  }
+  poolScript += "pool.count\npool.work -1\npool.work 100\n";
+  DeusBatchResult poolResult;
+  poolConsole.runBatch(poolScript, poolResult);
+  bool poolInOrder = poolResult.entries.size() == 103;
+  for (int i = 0; i < 100 && poolInOrder; i++) {
+    poolInOrder = poolResult.getOutput(i) == std::to_string(i) && poolResult.entries[i].line == (size_t)i + 1;
+  }
+  expectEqual(poolInOrder, true, "Parallel batch results are recorded in order");
+  expectEqual(poolResult.getOutput(100), "100", "Methods that arent thread safe wait for parallel methods");
+  expectEqual(poolResult.entries[101].success, false, "Parallel batch records errors");
+  expectEqual(poolResult.errorCount, (size_t)1, "Parallel batch counts errors");
+  expectEqual(poolResult.getOutput(102), "100", "Parallel batch runs methods after an error");
+  poolConsole.setWorkerCount(0);
+  expectEqual(poolConsole.getWorkerCount(), (size_t)0, "Worker pool can be stopped");
+
+  // Test scans over the registry columns follow registration order
+  IDeusConsoleManager scanConsole;
+  int scanValues[3] = {};
+  scanConsole.registerCVar("scan.first", scanValues[0], "First", DEUS_CVAR_DEVELOPER);
+  scanConsole.registerMethod("scan.method", [](DeusCommandType&) {}, "Method", DEUS_METHOD_THREADSAFE);
+  scanConsole.registerCVar("scan.second", scanValues[1], "Second");
+  scanConsole.registerCVar("scan.third", scanValues[2], "Third", DEUS_CVAR_DEVELOPER | DEUS_CVAR_READONLY);
+  std::string scanOrder;
+  scanConsole.forEachHelp([&scanOrder](std::string_view name, const char*) {
+    scanOrder.append(name).append(" ");
+  });
+  expectEqual(scanOrder, "scan.first scan.method scan.second scan.third ", "Help entries are listed in registration order");
+  std::vector<std::string_view> scanNames;
+  scanConsole.findVariablesWithFlags(DEUS_CVAR_DEVELOPER, scanNames);
+  const bool scanFound = scanNames.size() == 2 && scanNames[0] == "scan.first" && scanNames[1] == "scan.third";
+  expectEqual(scanFound, true, "Finding variables by flags returns matching variables only");
+
+  // Test completion returns sorted matches and their common prefix
+  scanConsole.registerCVar("scan.thirty", scanValues[0]);
+  std::vector<std::string_view> completions;
+  std::string_view commonPrefix = scanConsole.complete("scan.th", completions);
+  const bool completedSorted = completions.size() == 2 && completions[0] == "scan.third" && completions[1] == "scan.thirty";
+  expectEqual(completedSorted, true, "Completion returns every match in sorted order");
+  expectEqual(commonPrefix, "scan.thir", "Completion returns the longest common prefix");
+  commonPrefix = scanConsole.complete("scan.se", completions);
+  expectEqual(commonPrefix, "scan.second", "Completion of a single match returns the whole name");
+  commonPrefix = scanConsole.complete("scan.", completions, 2);
+  const bool completedLimited = completions.size() == 2 && completions[0] == "scan.first" && completions[1] == "scan.method";
+  expectEqual(completedLimited, true, "Completion stops at the match limit");
+  expectEqual(commonPrefix, "scan.", "Completion common prefix can be the prefix itself");
+  commonPrefix = scanConsole.complete("scan.x", completions);
+  expectEqual(completions.size(), (size_t)0, "Completion of an unknown prefix has no matches");
+
+  // Test fuzzy search ranks word start and name matches first
+  IDeusConsoleManager searchConsole;
+  int searchValues[4] = { 0, 0, 0, 0 };
+  searchConsole.registerCVar("r.shadow.cascade.count", searchValues[0], "Number of shadow cascades");
+  searchConsole.registerCVar("r.shadow.quality", searchValues[1], "Shadow quality");
+  searchConsole.registerCVar("r.screen.scale", searchValues[2], "Screen scale");
+  searchConsole.registerMethod("net.connect", [](DeusCommandType&) {}, "Connects to a server");
+  searchConsole.registerCVar("sv.server", searchValues[3], "");
+  std::vector<DeusSearchMatch> searchMatches;
+  searchConsole.search("cascount", searchMatches);
+  const bool searchFoundCascade = !searchMatches.empty() && searchMatches[0].name == "r.shadow.cascade.count";
+  expectEqual(searchFoundCascade, true, "Fuzzy search matches a subsequence across words");
+  searchConsole.search("rsq", searchMatches);
+  const bool searchFoundQuality = searchMatches.size() == 1 && searchMatches[0].name == "r.shadow.quality";
+  expectEqual(searchFoundQuality, true, "Fuzzy search matches word starts");
+  searchConsole.search("RSS", searchMatches);
+  const bool searchRanked = searchMatches.size() >= 2 && searchMatches[0].name == "r.screen.scale" && searchMatches[0].score > searchMatches[1].score;
+  expectEqual(searchRanked, true, "Fuzzy search ignores case and ranks word start matches first");
+  searchConsole.search("server", searchMatches);
+  const bool searchDescription = searchMatches.size() == 2 && searchMatches[0].name == "sv.server" && searchMatches[1].name == "net.connect";
+  expectEqual(searchDescription, true, "Fuzzy search matches descriptions below names");
+  searchConsole.search("s", searchMatches, 2);
+  expectEqual(searchMatches.size(), (size_t)2, "Fuzzy search stops at the match limit");
+  searchConsole.search("zzz", searchMatches);
+  expectEqual(searchMatches.size(), (size_t)0, "Fuzzy search with no matches is empty");
+
+  // Test namespace queries only visit their subtree and reset restores registered values
+  IDeusConsoleManager namespaceConsole;
+  namespaceConsole.bindBaseCommands();
+  int nsFirst = 1;
+  float nsSecond = 2.5f;
+  int nsNested = 3;
+  int nsOther = 4;
+  namespaceConsole.registerCVar("ns.b", nsSecond, "Second");
+  namespaceConsole.registerCVar("ns.a", nsFirst, "First");
+  namespaceConsole.registerCVar("ns.sub.c", nsNested, "Nested");
+  namespaceConsole.registerCVar("nsx.d", nsOther, "Other");
+  namespaceConsole.registerMethod("ns.run", [](DeusCommandType&) {}, "Method");
+  std::string nsNames;
+  namespaceConsole.forEachInNamespace("ns", [&nsNames](std::string_view name, const char*) {
+    nsNames.append(name).append(" ");
+  });
+  expectEqual(nsNames, "ns.a ns.b ns.run ns.sub.c ", "Namespace query returns the subtree sorted by name");
+  nsNames.clear();
+  namespaceConsole.forEachInNamespace("ns.", [&nsNames](std::string_view name, const char*) {
+    nsNames.append(name).append(" ");
+  });
+  expectEqual(nsNames, "ns.a ns.b ns.run ns.sub.c ", "Namespace query ignores a trailing dot");
+  nsNames.clear();
+  namespaceConsole.forEachInNamespace("*.?", [&nsNames](std::string_view name, const char*) {
+    nsNames.append(name).append(" ");
+  });
+  expectEqual(nsNames, "ns.a ns.b ns.sub.c nsx.d ", "Wildcard query matches whole names across dots");
+  expectEqual(namespaceConsole.runCommand("list ns.s*"), "ns.sub.c = 3\n", "List shows variables matching a pattern with values");
+  expectEqual(namespaceConsole.runCommand("help ns.sub"), "Method/variable list:\nns.sub.c\t\tNested\n", "Help can be limited to a namespace");
+  expectEqual(namespaceConsole.runCommand("list ns.sub."), namespaceConsole.runCommand("list ns.sub"), "List of a namespace with a trailing dot matches the namespace");
+  expectEqual(namespaceConsole.runCommand("help ns.sub."), namespaceConsole.runCommand("help ns.sub"), "Help of a namespace with a trailing dot matches the namespace");
+  namespaceConsole.runCommand("ns.a 10");
+  namespaceConsole.runCommand("ns.sub.c 30");
+  namespaceConsole.runCommand("nsx.d 40");
+  expectEqual(namespaceConsole.runCommand("reset ns.*"), "Reset 3 variables", "Reset counts variables in the namespace");
+  const bool nsReset = nsFirst == 1 && nsSecond == 2.5f && nsNested == 3 && nsOther == 40;
+  expectEqual(nsReset, true, "Reset restores registered values inside the namespace only");
+
+  // Test output sinks receive the same output streamed piece by piece
+  std::string sinkOutput;
+  size_t sinkWrites = 0;
+  auto sinkWrite = [&sinkOutput, &sinkWrites](std::string_view text) {
+    sinkOutput.append(text);
+    sinkWrites++;
+  };
+  namespaceConsole.runCommand("list ns.sub; ns.run; ns.a", sinkWrite);
+  expectEqual(sinkOutput, namespaceConsole.runCommand("list ns.sub; ns.run; ns.a"), "Sink output of chained commands matches returned output");
+  sinkOutput.clear();
+  sinkWrites = 0;
+  namespaceConsole.runCommand("help", sinkWrite);
+  const bool sinkStreamed = sinkWrites > 1 && sinkOutput == namespaceConsole.runCommand("help");
+  expectEqual(sinkStreamed, true, "Help streams into a sink");
+  sinkOutput.clear();
+  namespaceConsole.runCommand("list ns.sub", [&sinkOutput](std::string_view text) {
+    sinkOutput.append(text);
+  });
+  expectEqual(sinkOutput, "ns.sub.c = 3\n", "Temporary lambda can be passed as a sink");
+
+  // Test the output ring keeps only the newest lines in fixed memory
+  DeusOutputRing outputRing(4, 64);
+  outputRing.append("first\nsecond\n");
+  outputRing.append("");
+  std::string ringLine;
+  const bool ringSplit = outputRing.size() == 3 && outputRing.getLine(1, ringLine) && ringLine == "second";
+  expectEqual(ringSplit, true, "Output ring splits appended text into lines");
+  outputRing.append("third\nfourth\nfifth");
+  std::string ringLines;
+  outputRing.forEachLast(10, [&ringLines](std::string_view line) {
+    ringLines.append(line).append(",");
+  });
+  expectEqual(ringLines, ",third,fourth,fifth,", "Output ring overwrites the oldest lines");
+  const bool ringDropped = outputRing.begin() == 2 && !outputRing.getLine(1, ringLine);
+  expectEqual(ringDropped, true, "Output ring drops overwritten lines");
+  outputRing.appendLine(std::string(100, 'x'));
+  const bool ringTruncated = outputRing.getLine(outputRing.end() - 1, ringLine) && ringLine.size() == 64 && !outputRing.getLine(outputRing.end() - 2, ringLine);
+  expectEqual(ringTruncated, true, "Output ring truncates long lines and drops lines whose text was overwritten");
+  outputRing.clear();
+  expectEqual(outputRing.size(), (size_t)0, "Output ring can be cleared");
+
+  // Test several threads can append to the output ring at once
+  DeusOutputRing threadRing(8192, 1 << 20);
+  std::vector<std::thread> ringThreads;
+  for (int t = 0; t < 4; t++) {
+    ringThreads.emplace_back([&threadRing, t]() {
+      for (int i = 0; i < 1000; i++) {
+        threadRing.appendLine("thread " + std::to_string(t) + " line " + std::to_string(i));
+      }
+    });
+  }
+  for (std::thread& thread : ringThreads) {
+    thread.join();
+  }
+  size_t ringIntact = 0;
+  threadRing.forEachLast(SIZE_MAX, [&ringIntact](std::string_view line) {
+    if (line.substr(0, 7) == "thread " && line.find(" line ") != std::string_view::npos) {
+      ringIntact++;
+    }
+  });
+  expectEqual(ringIntact, (size_t)4000, "Output ring keeps every line appended from several threads intact");
+
+  // Test writers lapping each other on a tiny ring never let a reader see one line with another lines text
+  DeusOutputRing lapRing(4, 1 << 20);
+  auto lapLine = [](int t, int i) {
+    return "w" + std::to_string(t) + "." + std::to_string(i) + ":" + std::string(i % 23, (char)('a' + t));
+  };
+  std::atomic<bool> lapWriting(true);
+  std::atomic<size_t> lapTorn(0);
+  std::thread lapReader([&]() {
+    std::string line;
+    while (lapWriting.load()) {
+      for (uint64_t index = lapRing.begin(); index < lapRing.end(); index++) {
+        int t = 0;
+        int i = 0;
+        if (lapRing.getLine(index, line) && (sscanf(line.c_str(), "w%d.%d:", &t, &i) != 2 || line != lapLine(t, i))) {
+          lapTorn++;
+        }
+      }
+    }
+  });
+  std::vector<std::thread> lapWriters;
+  for (int t = 0; t < 4; t++) {
+    lapWriters.emplace_back([&lapRing, &lapLine, t]() {
+      for (int i = 0; i < 2000; i++) {
+        lapRing.appendLine(lapLine(t, i));
+      }
+    });
+  }
+  for (std::thread& thread : lapWriters) {
+    thread.join();
+  }
+  lapWriting = false;
+  lapReader.join();
+  expectEqual(lapTorn.load(), (size_t)0, "Output ring writers lapping each other never mix up lines");
+
+  // Test typed methods convert their arguments and return values
+  IDeusConsoleManager typedConsole;
+  std::string typedName;
+  typedConsole.registerMethod("typed.scale", [](int a, float b) {
+    return a * b;
+  }, "Multiplies an integer by a number");
+  typedConsole.registerMethod("typed.name", [&typedName](std::string_view name, bool upper) {
+    typedName = upper ? "UPPER " + std::string(name) : std::string(name);
+  });
+  typedConsole.registerMethod("typed.greet", [](const std::string& name) {
+    return "hello " + name;
+  });
+  expectEqual(typedConsole.runCommand("typed.scale 3 1.5"), "4.5", "Typed method converts arguments and formats return value");
+  typedConsole.runCommand("typed.name 'some name' true");
+  expectEqual(typedName, "UPPER some name", "Typed method receives string view and bool arguments");
+  expectEqual(typedConsole.runCommand("typed.greet world"), "hello world", "Typed method returns a string");
+  std::string typedError;
+  try {
+    typedConsole.runCommand("typed.scale 3");
+  } catch (const DeusConsoleException& e) {
+    typedError = e.what();
+  }
+  expectEqual(typedError, "typed.scale expects 2 arguments, got 1", "Typed method reports wrong argument count");
+  try {
+    typedConsole.runCommand("typed.scale 3 abc");
+  } catch (const DeusConsoleException& e) {
+    typedError = e.what();
+  }
+  expectEqual(typedError, "Argument 2 of typed.scale must be a number: Invalid number: abc", "Typed method reports invalid argument");
 
   // Can get help text for a console variable
   expectEqual(console->getHelp("test.uint"), "A test uint8_t variable", "test.uint help text is correct");
@@ -179,6 +936,21 @@ int main(int argc, char* argv[]) {
   varReadValue = console->runCommand("test.string");
   expectEqual(varReadValue, "another test str", "Can run command to get string representation of variable (string)");
 
+  // Reading an existing variable in a steady state doesnt touch the heap
+  std::string allocReadValue;
+  console->runCommand("test.integer", allocReadValue);
+  const size_t allocsBeforeRead = heapAllocCount;
+  console->runCommand("test.integer", allocReadValue);
+  expectEqual(heapAllocCount - allocsBeforeRead, (size_t)0, "Reading a variable with runCommand doesnt allocate");
+
+  // Variable records share a static operations table per type instead of holding callbacks
+  const bool compactRecord = sizeof(DeusConsoleVariable) <= 64;
+  expectEqual(compactRecord, true, "Console variable records are compact");
+  const size_t allocsBeforeWrite = heapAllocCount;
+  console->runCommand("test.integer 12345", allocReadValue);
+  console->runCommand("test.integer 54321", allocReadValue);
+  expectEqual(heapAllocCount - allocsBeforeWrite, (size_t)0, "Writing a numeric variable with runCommand doesnt allocate");
+
   // Run without arguments or expecting a return value
   console->runCommand("myMethod");
   expectEqual(true, true, "Simple myMethod command can be ran without return value");
@@ -218,6 +990,38 @@ int main(int argc, char* argv[]) {
   console->bindBaseCommands();
   std::cout << console->runCommand("help") << std::endl;
 
+  // Test running script files
+  FILE* scriptFile = fopen("test_exec.cfg", "wb");
+  fputs("// Test script file\ntest.integer 99\ntest.string 'from a file' // trailing comment\ntest.doesnt.exist 1\n\ntest.float 1.5; test.bool true\n", scriptFile);
+  fclose(scriptFile);
+
+  DeusBatchResult execResult;
+  size_t execErrors = console->execFile("test_exec.cfg", execResult);
+  expectEqual(execErrors, (size_t)1, "Script file reports failed commands");
+  expectEqual(execResult.entries.size(), (size_t)5, "Script file runs every command");
+  expectEqual(execResult.entries[2].line, (size_t)4, "Script file errors report their line");
+  expectEqual(console->getCVar<std::string>("test.string"), "from a file", "Script file changes string variable");
+  expectEqual(console->getCVar<float>("test.float"), 1.5f, "Script file runs chained commands");
+
+  std::string execOutput = console->runCommand("exec test_exec.cfg");
+  const bool execReportedLine = execOutput.find("test_exec.cfg:4: ") == 0;
+  expectEqual(execReportedLine, true, "exec command reports errors with line numbers");
+  remove("test_exec.cfg");
+
+  didThrow = false;
+  try {
+    console->runCommand("exec this_file_doesnt_exist.cfg");
+  } catch (const DeusConsoleException&) {
+    didThrow = true;
+  }
+  expectEqual(didThrow, true, "exec command throws when file is missing");
+
+  // Test slashes inside a value arent a comment, but a comment after whitespace still is
+  console->runCommand("test.string http://example.com/x");
+  expectEqual(console->getCVar<std::string>("test.string"), "http://example.com/x", "URL value keeps its slashes");
+  console->runCommand("test.string http://example.com/y // comment");
+  expectEqual(console->getCVar<std::string>("test.string"), "http://example.com/y", "Comment after a URL value is stripped");
+
   // Run user provided command from cli
   if (argc > 1) {
     std::string inputStr;